@@ -0,0 +1,135 @@
+#include <chrono>
+#include "analysis.h"
+#include "search.h"
+
+// How long the idle worker sleeps between looks at its command queue
+constexpr int IDLE_POLL_MS = 2;
+
+AnalysisEngine::AnalysisEngine() : worker(&AnalysisEngine::workerLoop, this) {}
+
+AnalysisEngine::~AnalysisEngine() {
+    Command quit;
+    quit.type = CommandType::QUIT;
+    send(std::move(quit));
+    worker.join();
+}
+
+void AnalysisEngine::send(Command&& command) {
+    const CommandType type = command.type;
+
+    // The worker drains the queue every few milliseconds, so a full queue
+    // only ever lasts a moment
+    while (!commands.push(std::move(command))) {
+        std::this_thread::yield();
+    }
+
+    // Pushed first, stopped second: a search the worker starts after this
+    // point sees the command in the queue before it begins
+    if (type != CommandType::START) requestStop();
+}
+
+void AnalysisEngine::setPosition(const Position& pos, const std::vector<Key>& history) {
+    Command command;
+    command.type = CommandType::SET_POSITION;
+    command.generation = ++generation;
+    command.position = pos;
+    command.history = history;
+    send(std::move(command));
+}
+
+void AnalysisEngine::start() {
+    Command command;
+    command.type = CommandType::START;
+    send(std::move(command));
+    running = true;
+}
+
+void AnalysisEngine::stop() {
+    Command command;
+    command.type = CommandType::STOP;
+    send(std::move(command));
+    running = false;
+}
+
+bool AnalysisEngine::poll(AnalysisUpdate& update) {
+    bool found = false;
+    AnalysisUpdate next;
+    while (updates.pop(next)) {
+        // Updates for an earlier position may still be in flight
+        if (next.generation != generation) continue;
+        if (next.finished) running = false;
+        update = std::move(next);
+        found = true;
+    }
+    return found;
+}
+
+void AnalysisEngine::workerLoop() {
+    Position position;
+    position.setFromFEN(START_FEN);
+    std::vector<Key> history;
+    unsigned int currentGeneration = 0;
+    bool active = false;        // Analysis requested
+    bool pending = false;       // The current position has not been searched yet
+
+    for (;;) {
+        Command command;
+        while (commands.pop(command)) {
+            switch (command.type) {
+                case CommandType::SET_POSITION:
+                    position = command.position;
+                    history = std::move(command.history);
+                    currentGeneration = command.generation;
+                    pending = true;
+                    break;
+                case CommandType::START:
+                    active = true;
+                    pending = true;
+                    break;
+                case CommandType::STOP:
+                    active = false;
+                    break;
+                case CommandType::QUIT:
+                    return;
+            }
+        }
+
+        if (!active || !pending) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_POLL_MS));
+            continue;
+        }
+
+        // A command that arrived since the drain above raised the stop flag
+        // before prepareSearch() lowered it again: handle it first
+        prepareSearch(false);
+        if (!commands.empty()) continue;
+        pending = false;
+
+        SearchLimits limits;
+        limits.infinite = true;
+        auto report = [&](const SearchResult& result, bool finished) {
+            AnalysisUpdate update;
+            update.generation = currentGeneration;
+            update.depth = result.depth;
+            update.score = result.score;
+            update.nodes = result.nodes;
+            update.nps = result.timeMs > 0 ? result.nodes * 1000 / result.timeMs : result.nodes;
+            update.bestMove = result.bestMove;
+            update.pv = result.pv;
+            update.finished = finished;
+
+            // A GUI that falls behind only misses intermediate iterations
+            updates.push(std::move(update));
+        };
+
+        const SearchResult result = searchPosition(position, limits, history,
+                                                   [&](const SearchResult& iteration) { report(iteration, false); });
+
+        // Stopped by a command: the GUI has moved on. Otherwise there is
+        // nothing deeper to search, so the analysis is complete.
+        if (!isStopRequested()) {
+            report(result, true);
+            active = false;
+        }
+    }
+}
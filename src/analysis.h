@@ -0,0 +1,80 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "position.h"
+#include "move.h"
+#include "spsc_queue.h"
+
+// One snapshot of a running analysis, sent after every completed iteration
+struct AnalysisUpdate {
+    unsigned int generation = 0;    // Position the update belongs to (see AnalysisEngine::setPosition)
+    int depth = 0;
+    int score = 0;                  // From the side to move's point of view
+    long long nodes = 0;
+    long long nps = 0;
+    Move bestMove = NO_MOVE;
+    std::vector<Move> pv;
+    bool finished = false;          // The search ended on its own (e.g. a forced mate was found)
+};
+
+/**
+ * @brief Runs the engine on a worker thread for live analysis in the GUI
+ *
+ * The GUI thread sends commands and the worker streams back an update per
+ * iteration, each through its own lock-free SPSC queue, so neither side
+ * ever waits on the other: the GUI keeps rendering at full frame rate while
+ * the worker searches. Commands that replace or end the analysis also raise
+ * the search's stop flag so the worker picks them up within a few nodes.
+ * All member functions must be called from one (the GUI) thread.
+ */
+class AnalysisEngine {
+public:
+    AnalysisEngine();
+    ~AnalysisEngine();
+
+    AnalysisEngine(const AnalysisEngine&) = delete;
+    AnalysisEngine& operator=(const AnalysisEngine&) = delete;
+
+    /**
+     * @brief Sets the position to analyse; restarts a running analysis on it
+     * @param history Keys of the game's earlier positions, oldest first
+     */
+    void setPosition(const Position& pos, const std::vector<Key>& history);
+
+    // Starts (or restarts) an infinite analysis of the current position
+    void start();
+    void stop();
+    bool isRunning() const { return running; }
+
+    /**
+     * @brief Takes the updates that arrived since the last call
+     * @return True if any belonged to the current position, with the newest in update
+     */
+    bool poll(AnalysisUpdate& update);
+
+private:
+    enum class CommandType { SET_POSITION, START, STOP, QUIT };
+
+    struct Command {
+        CommandType type = CommandType::STOP;
+        unsigned int generation = 0;
+        Position position;
+        std::vector<Key> history;
+    };
+
+    static constexpr std::size_t QUEUE_SIZE = 64;
+
+    SPSCQueue<Command, QUEUE_SIZE> commands;        // GUI -> worker
+    SPSCQueue<AnalysisUpdate, QUEUE_SIZE> updates;  // Worker -> GUI
+    unsigned int generation = 0;                    // GUI side: bumped for every new position
+    bool running = false;                           // GUI side view of the worker
+    std::thread worker;
+
+    void send(Command&& command);
+    void workerLoop();
+};
+
+#endif // ANALYSIS_H
@@ -0,0 +1,107 @@
+#include "attacks.h"
+
+Magic ROOK_MAGICS[64];
+Magic BISHOP_MAGICS[64];
+
+// Every square's attack slice packed back to back (sum of 2^popCount(mask))
+static Bitboard ROOK_TABLE[0x19000];
+static Bitboard BISHOP_TABLE[0x1480];
+
+using StepFn = Bitboard (*)(Bitboard);
+
+static const StepFn ROOK_STEPS[4] = {shiftNorth, shiftSouth, shiftEast, shiftWest};
+static const StepFn BISHOP_STEPS[4] = {shiftNorthEast, shiftNorthWest, shiftSouthEast, shiftSouthWest};
+
+// Slow ray walk used only to fill the tables
+static Bitboard slidingAttacks(int sq, Bitboard occupied, const StepFn steps[4]) {
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; ++d) {
+        Bitboard b = squareBB(sq);
+        while ((b = steps[d](b)) != 0) {
+            attacks |= b;
+            if (b & occupied) break;
+        }
+    }
+    return attacks;
+}
+
+// xorshift64* generator; fixed seeds keep the magic search fast and repeatable
+class MagicRng {
+    std::uint64_t state;
+
+public:
+    explicit MagicRng(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    // Magics with few set bits are found much sooner
+    std::uint64_t sparse() { return next() & next() & next(); }
+};
+
+static void initMagics(Bitboard table[], Magic magics[], const StepFn steps[4]) {
+    static Bitboard reference[4096];
+    int size = 0;
+#ifndef USE_PEXT
+    // Seeds per rank known to find all magics within a few thousand tries
+    static const std::uint64_t SEEDS[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+    static Bitboard occupancy[4096];
+    static int epoch[4096];
+    int attempt = 0;
+#endif
+
+    for (int sq = 0; sq < 64; ++sq) {
+        Magic& m = magics[sq];
+
+        // Board edges never block unless the slider stands on that edge
+        const Bitboard edges = ((RANK_1_BB | RANK_8_BB) & ~(RANK_1_BB << (8 * rankOf(sq)))) |
+                               ((FILE_A_BB | FILE_H_BB) & ~(FILE_A_BB << fileOf(sq)));
+        m.mask = slidingAttacks(sq, 0, steps) & ~edges;
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = (sq == 0) ? table : magics[sq - 1].attacks + size;
+
+        // Enumerate every subset of the mask (carry-rippler trick)
+        Bitboard b = 0;
+        size = 0;
+        do {
+            reference[size] = slidingAttacks(sq, b, steps);
+#ifdef USE_PEXT
+            m.attacks[_pext_u64(b, m.mask)] = reference[size];
+#else
+            occupancy[size] = b;
+#endif
+            size++;
+            b = (b - m.mask) & m.mask;
+        } while (b);
+
+#ifndef USE_PEXT
+        // Try random magics until one maps every subset without a harmful collision
+        MagicRng rng(SEEDS[rankOf(sq)]);
+        for (int i = 0; i < size;) {
+            for (m.magic = 0; popCount((m.magic * m.mask) >> 56) < 6;) {
+                m.magic = rng.sparse();
+            }
+
+            ++attempt;
+            for (i = 0; i < size; ++i) {
+                const unsigned idx = m.index(occupancy[i]);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                } else if (m.attacks[idx] != reference[i]) {
+                    break;
+                }
+            }
+        }
+#endif
+    }
+}
+
+void initAttacks() {
+    initMagics(ROOK_TABLE, ROOK_MAGICS, ROOK_STEPS);
+    initMagics(BISHOP_TABLE, BISHOP_MAGICS, BISHOP_STEPS);
+}
@@ -0,0 +1,145 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include <array>
+#include "bitboard.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#define USE_PEXT 1
+#endif
+
+/**
+ * @brief Lookup data for one square's sliding attacks
+ *
+ * The relevant occupancy (blockers inside the mask) is hashed to an index
+ * into the square's slice of the attack table, either with a magic multiply
+ * or, on CPUs with BMI2, with a single PEXT instruction.
+ */
+struct Magic {
+    Bitboard mask;      // Squares whose occupancy can block the slider
+    Bitboard magic;     // Multiplier that maps each mask subset to a unique index
+    Bitboard* attacks;  // Start of this square's attack slice
+    unsigned shift;     // 64 - popCount(mask)
+
+    unsigned index(Bitboard occupied) const {
+#ifdef USE_PEXT
+        return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+        return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+using SquareTable = std::array<Bitboard, 64>;
+using SquarePairTable = std::array<SquareTable, 64>;
+
+// The leaper and line tables are generated by the compiler, so they need no
+// startup work and sit in read-only memory
+constexpr SquareTable makePawnAttacks(PieceColor color) {
+    SquareTable table{};
+    for (int sq = 0; sq < 64; ++sq) {
+        const Bitboard b = squareBB(sq);
+        table[sq] = color == PieceColor::WHITE ? shiftNorthEast(b) | shiftNorthWest(b)
+                                               : shiftSouthEast(b) | shiftSouthWest(b);
+    }
+    return table;
+}
+
+constexpr SquareTable makeKnightAttacks() {
+    SquareTable table{};
+    for (int sq = 0; sq < 64; ++sq) {
+        const Bitboard b = squareBB(sq);
+        const Bitboard east = shiftEast(b);
+        const Bitboard west = shiftWest(b);
+        const Bitboard east2 = shiftEast(east);
+        const Bitboard west2 = shiftWest(west);
+        table[sq] = ((east | west) << 16) | ((east | west) >> 16) |
+                    ((east2 | west2) << 8) | ((east2 | west2) >> 8);
+    }
+    return table;
+}
+
+constexpr SquareTable makeKingAttacks() {
+    SquareTable table{};
+    for (int sq = 0; sq < 64; ++sq) {
+        const Bitboard b = squareBB(sq);
+        const Bitboard row = b | shiftEast(b) | shiftWest(b);
+        table[sq] = (row | shiftNorth(row) | shiftSouth(row)) & ~b;
+    }
+    return table;
+}
+
+// Walks the eight rays from every square: each square met on a ray gets the
+// segment walked so far (between) and both rays of that line (line)
+constexpr SquarePairTable makeLineTable(bool between) {
+    constexpr int FILE_STEPS[8] = {0, 0, 1, -1, 1, -1, -1, 1};
+    constexpr int RANK_STEPS[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+    SquarePairTable table{};
+    for (int a = 0; a < 64; ++a) {
+        for (int dir = 0; dir < 8; ++dir) {
+            // Opposite directions are neighbours in the step lists
+            Bitboard line = squareBB(a);
+            for (int d = dir & ~1; d <= (dir | 1); ++d) {
+                for (int f = fileOf(a) + FILE_STEPS[d], r = rankOf(a) + RANK_STEPS[d];
+                     f >= 0 && f < 8 && r >= 0 && r < 8; f += FILE_STEPS[d], r += RANK_STEPS[d]) {
+                    line |= squareBB(makeSquare(f, r));
+                }
+            }
+
+            Bitboard segment = 0;
+            for (int f = fileOf(a) + FILE_STEPS[dir], r = rankOf(a) + RANK_STEPS[dir];
+                 f >= 0 && f < 8 && r >= 0 && r < 8; f += FILE_STEPS[dir], r += RANK_STEPS[dir]) {
+                const int b = makeSquare(f, r);
+                table[a][b] = between ? segment : line;
+                segment |= squareBB(b);
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr SquareTable PAWN_ATTACKS[COLOR_COUNT] = {makePawnAttacks(PieceColor::WHITE),
+                                                         makePawnAttacks(PieceColor::BLACK)};
+inline constexpr SquareTable KNIGHT_ATTACKS = makeKnightAttacks();
+inline constexpr SquareTable KING_ATTACKS = makeKingAttacks();
+
+// Squares strictly between two squares on a shared rank, file or diagonal (else empty)
+inline constexpr SquarePairTable BETWEEN_BB = makeLineTable(true);
+// The whole rank, file or diagonal through two squares, edge to edge (else empty)
+inline constexpr SquarePairTable LINE_BB = makeLineTable(false);
+
+extern Magic ROOK_MAGICS[64];
+extern Magic BISHOP_MAGICS[64];
+
+/**
+ * @brief Finds the slider magics and fills their attack tables
+ *
+ * Must run once at program startup, before any position is set up. The
+ * sliding tables stay runtime-built: finding magics for the 100k rook and
+ * bishop entries is far beyond what the compiler will evaluate.
+ */
+void initAttacks();
+
+// Constant-time attack lookups
+inline Bitboard pawnAttacks(PieceColor color, int sq) { return PAWN_ATTACKS[static_cast<int>(color)][sq]; }
+template <PieceColor Us>
+inline Bitboard pawnAttacks(int sq) { return PAWN_ATTACKS[static_cast<int>(Us)][sq]; }
+inline Bitboard knightAttacks(int sq) { return KNIGHT_ATTACKS[sq]; }
+inline Bitboard kingAttacks(int sq) { return KING_ATTACKS[sq]; }
+
+inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+    const Magic& m = ROOK_MAGICS[sq];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    const Magic& m = BISHOP_MAGICS[sq];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+    return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied);
+}
+
+#endif // ATTACKS_H
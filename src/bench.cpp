@@ -0,0 +1,213 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include "bench.h"
+#include "perft.h"
+#include "search.h"
+#include "tt.h"
+
+// One position of the suite with its perft depth and reference count
+struct BenchPosition {
+    const char* name;
+    const char* fen;
+    int perftDepth;
+    long long perftNodes;
+};
+
+// Standard perft positions plus endgames and promotion races, so every
+// kind of move (castling, en passant, under-promotion) is exercised
+static const BenchPosition BENCH_POSITIONS[] = {
+    {"startpos",    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609},
+    {"kiwipete",    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603},
+    {"cpw-pos3",    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083},
+    {"cpw-pos4",    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292},
+    {"cpw-pos5",    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487},
+    {"cpw-pos6",    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594},
+    {"rook-end",    "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888},
+    {"bishop-end",  "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", 6, 1015133},
+    {"queen-end",   "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4, 23527},
+    {"castle-end",  "5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072},
+    {"en-passant",  "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467},
+    {"promo-race",  "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1", 5, 3605103},
+    {"promo-pawn",  "8/P1k5/K7/8/8/8/8/8 w - - 0 1", 6, 92683},
+    {"promo-king",  "8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7, 567584},
+};
+
+// Measured figures for one position
+struct BenchEntry {
+    const char* name;
+    long long perftNodes;
+    double perftSeconds;
+    bool perftCorrect;
+    long long searchNodes;
+    double searchSeconds;
+    Move bestMove;
+    int score;
+};
+
+// Search counters summed over the suite; only filled in trace builds
+struct BenchTrace {
+    TraceCounters counters;
+    SearchStats stats;
+};
+
+static long long nodesPerSecond(long long nodes, double seconds) {
+    return seconds > 0.0 ? static_cast<long long>(nodes / seconds) : 0;
+}
+
+static void printHuman(const std::vector<BenchEntry>& entries, int searchDepth,
+                       long long perftNodes, double perftSeconds,
+                       long long searchNodes, double searchSeconds, bool allCorrect,
+                       const BenchTrace& trace) {
+    std::cout << std::left << std::setw(13) << "Position"
+              << std::right << std::setw(12) << "Perft" << std::setw(12) << "Perft nps"
+              << std::setw(12) << "Search" << std::setw(12) << "Search nps"
+              << "  Best" << std::endl;
+    std::cout << std::string(75, '-') << std::endl;
+
+    for (const BenchEntry& e : entries) {
+        std::cout << std::left << std::setw(13) << e.name
+                  << std::right << std::setw(12) << e.perftNodes
+                  << std::setw(12) << nodesPerSecond(e.perftNodes, e.perftSeconds)
+                  << std::setw(12) << e.searchNodes
+                  << std::setw(12) << nodesPerSecond(e.searchNodes, e.searchSeconds)
+                  << "  " << moveToUCI(e.bestMove)
+                  << (e.perftCorrect ? "" : "  PERFT MISMATCH") << std::endl;
+    }
+
+    std::cout << std::string(75, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Perft nodes   : " << perftNodes << " in " << perftSeconds << " s ("
+              << nodesPerSecond(perftNodes, perftSeconds) << " nps)"
+              << (allCorrect ? "" : " - INCORRECT") << std::endl;
+    std::cout << "Search nodes  : " << searchNodes << " in " << searchSeconds << " s ("
+              << nodesPerSecond(searchNodes, searchSeconds) << " nps) at depth " << searchDepth << std::endl;
+    std::cout << "Signature     : " << searchNodes << std::endl;
+    if (TRACE_ENABLED) {
+        std::cout << "Trace         : " << traceSummary(trace.counters, trace.stats, searchNodes) << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+static void printJSON(const std::vector<BenchEntry>& entries, int searchDepth,
+                      long long perftNodes, double perftSeconds,
+                      long long searchNodes, double searchSeconds, bool allCorrect,
+                      const BenchTrace& trace) {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "{\"depth\":" << searchDepth << ",\"positions\":[";
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const BenchEntry& e = entries[i];
+        std::cout << (i ? "," : "")
+                  << "{\"name\":\"" << e.name << "\""
+                  << ",\"perft_nodes\":" << e.perftNodes
+                  << ",\"perft_seconds\":" << e.perftSeconds
+                  << ",\"perft_correct\":" << (e.perftCorrect ? "true" : "false")
+                  << ",\"search_nodes\":" << e.searchNodes
+                  << ",\"search_seconds\":" << e.searchSeconds
+                  << ",\"best_move\":\"" << moveToUCI(e.bestMove) << "\""
+                  << ",\"score\":" << e.score << "}";
+    }
+    std::cout << "],\"perft_nodes\":" << perftNodes
+              << ",\"perft_seconds\":" << perftSeconds
+              << ",\"perft_nps\":" << nodesPerSecond(perftNodes, perftSeconds)
+              << ",\"perft_correct\":" << (allCorrect ? "true" : "false")
+              << ",\"search_nodes\":" << searchNodes
+              << ",\"search_seconds\":" << searchSeconds
+              << ",\"search_nps\":" << nodesPerSecond(searchNodes, searchSeconds)
+              << ",\"signature\":" << searchNodes;
+    if (TRACE_ENABLED) std::cout << ",\"trace\":" << traceJSON(trace.counters, trace.stats, searchNodes);
+    std::cout << "}" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// One row per position followed by a "total" row
+static void printCSV(const std::vector<BenchEntry>& entries, int searchDepth,
+                     long long perftNodes, double perftSeconds,
+                     long long searchNodes, double searchSeconds, bool allCorrect) {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "name,depth,perft_nodes,perft_seconds,perft_correct,search_nodes,search_seconds,best_move,score"
+              << std::endl;
+    for (const BenchEntry& e : entries) {
+        std::cout << e.name << "," << searchDepth << "," << e.perftNodes << "," << e.perftSeconds << ","
+                  << (e.perftCorrect ? 1 : 0) << "," << e.searchNodes << "," << e.searchSeconds << ","
+                  << moveToUCI(e.bestMove) << "," << e.score << std::endl;
+    }
+    std::cout << "total," << searchDepth << "," << perftNodes << "," << perftSeconds << ","
+              << (allCorrect ? 1 : 0) << "," << searchNodes << "," << searchSeconds << ",,"
+              << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+bool runBench(int searchDepth, const std::string& format) {
+    if (searchDepth < 1) searchDepth = 1;
+    if (searchDepth > MAX_PLY - 1) searchDepth = MAX_PLY - 1;
+
+    // Node counts depend on the hash size and thread count, so pin both
+    const std::size_t savedHashMB = TT.sizeMB();
+    const int savedThreads = getSearchThreads();
+    TT.resize(DEFAULT_HASH_MB);
+    setSearchThreads(1);
+
+    std::vector<BenchEntry> entries;
+    long long totalPerftNodes = 0;
+    long long totalSearchNodes = 0;
+    double totalPerftSeconds = 0.0;
+    double totalSearchSeconds = 0.0;
+    bool allCorrect = true;
+    BenchTrace trace;
+
+    for (const BenchPosition& bench : BENCH_POSITIONS) {
+        Position pos;
+        if (!pos.setFromFEN(bench.fen)) {
+            std::cerr << "Warning: Bad bench FEN '" << bench.fen << "'" << std::endl;
+            allCorrect = false;
+            continue;
+        }
+
+        BenchEntry entry{};
+        entry.name = bench.name;
+
+        // Plain single-threaded perft measures raw move generation speed
+        auto start = std::chrono::steady_clock::now();
+        entry.perftNodes = perft(pos, bench.perftDepth);
+        entry.perftSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        entry.perftCorrect = (entry.perftNodes == bench.perftNodes);
+
+        // Every search starts from an empty table
+        TT.clear();
+        SearchLimits limits;
+        limits.depth = searchDepth;
+        prepareSearch(false);
+        start = std::chrono::steady_clock::now();
+        const SearchResult result = searchPosition(pos, limits);
+        entry.searchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        entry.searchNodes = result.nodes;
+        entry.bestMove = result.bestMove;
+        entry.score = result.score;
+        trace.counters.add(result.trace);
+        trace.stats.add(result.stats);
+
+        totalPerftNodes += entry.perftNodes;
+        totalPerftSeconds += entry.perftSeconds;
+        totalSearchNodes += entry.searchNodes;
+        totalSearchSeconds += entry.searchSeconds;
+        allCorrect = allCorrect && entry.perftCorrect;
+        entries.push_back(entry);
+    }
+
+    TT.resize(savedHashMB);
+    setSearchThreads(savedThreads);
+
+    if (format == "json") {
+        printJSON(entries, searchDepth, totalPerftNodes, totalPerftSeconds,
+                  totalSearchNodes, totalSearchSeconds, allCorrect, trace);
+    } else if (format == "csv") {
+        printCSV(entries, searchDepth, totalPerftNodes, totalPerftSeconds,
+                 totalSearchNodes, totalSearchSeconds, allCorrect);
+    } else {
+        printHuman(entries, searchDepth, totalPerftNodes, totalPerftSeconds,
+                   totalSearchNodes, totalSearchSeconds, allCorrect, trace);
+    }
+    return allCorrect;
+}
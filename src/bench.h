@@ -0,0 +1,20 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <string>
+
+// Default depth of the fixed-depth searches run by the benchmark
+constexpr int DEFAULT_BENCH_DEPTH = 7;
+
+/**
+ * @brief Runs perft and a fixed-depth search over the built-in position suite
+ *
+ * Everything runs on one thread with a freshly cleared hash table, so the
+ * node counts are identical from run to run and their sum (the signature)
+ * changes only when move generation, search or evaluation change.
+ * @param format "human", "json" or "csv"
+ * @return False if a perft count does not match its reference value
+ */
+bool runBench(int searchDepth, const std::string& format);
+
+#endif // BENCH_H
@@ -0,0 +1,64 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <string>
+#include "chess_types.h"
+
+// A set of squares, one bit per square (bit 0 = a1, bit 63 = h8)
+using Bitboard = std::uint64_t;
+
+// Squares are numbered 0..63 in little-endian rank-file order (a1 = 0, h1 = 7, h8 = 63)
+constexpr int NO_SQUARE = 64;
+
+constexpr Bitboard FILE_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H_BB = FILE_A_BB << 7;
+constexpr Bitboard RANK_1_BB = 0xFFULL;
+constexpr Bitboard RANK_2_BB = RANK_1_BB << 8;
+constexpr Bitboard RANK_4_BB = RANK_1_BB << 24;
+constexpr Bitboard RANK_5_BB = RANK_1_BB << 32;
+constexpr Bitboard RANK_7_BB = RANK_1_BB << 48;
+constexpr Bitboard RANK_8_BB = RANK_1_BB << 56;
+
+// Square helpers
+inline constexpr int makeSquare(int file, int rank) { return rank * 8 + file; }
+inline constexpr int fileOf(int sq) { return sq & 7; }
+inline constexpr int rankOf(int sq) { return sq >> 3; }
+inline constexpr Bitboard squareBB(int sq) { return 1ULL << sq; }
+
+// Convert between the GUI's (file, row) coordinates and square indices
+inline constexpr int toSquare(const BoardPosition& pos) { return makeSquare(pos.first, 7 - pos.second); }
+inline constexpr BoardPosition toBoardPosition(int sq) { return {fileOf(sq), 7 - rankOf(sq)}; }
+
+// Bit manipulation - these compile down to single instructions with -march=native
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+inline int popLsb(Bitboard& b) {
+    const int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+inline bool moreThanOne(Bitboard b) { return (b & (b - 1)) != 0; }
+
+// One-step shifts that do not wrap around the board edges
+inline constexpr Bitboard shiftNorth(Bitboard b) { return b << 8; }
+inline constexpr Bitboard shiftSouth(Bitboard b) { return b >> 8; }
+inline constexpr Bitboard shiftEast(Bitboard b) { return (b & ~FILE_H_BB) << 1; }
+inline constexpr Bitboard shiftWest(Bitboard b) { return (b & ~FILE_A_BB) >> 1; }
+inline constexpr Bitboard shiftNorthEast(Bitboard b) { return (b & ~FILE_H_BB) << 9; }
+inline constexpr Bitboard shiftNorthWest(Bitboard b) { return (b & ~FILE_A_BB) << 7; }
+inline constexpr Bitboard shiftSouthEast(Bitboard b) { return (b & ~FILE_H_BB) >> 7; }
+inline constexpr Bitboard shiftSouthWest(Bitboard b) { return (b & ~FILE_A_BB) >> 9; }
+
+// Algebraic square names ("e4") and their parser (returns NO_SQUARE on bad input)
+inline std::string squareName(int sq) {
+    return {static_cast<char>('a' + fileOf(sq)), static_cast<char>('1' + rankOf(sq))};
+}
+inline int parseSquare(const std::string& name) {
+    if (name.size() < 2 || name[0] < 'a' || name[0] > 'h' || name[1] < '1' || name[1] > '8') {
+        return NO_SQUARE;
+    }
+    return makeSquare(name[0] - 'a', name[1] - '1');
+}
+
+#endif // BITBOARD_H
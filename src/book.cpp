@@ -0,0 +1,137 @@
+#include <iostream>
+#include <vector>
+#include "book.h"
+#include "movegen.h"
+
+OpeningBook BOOK;
+
+// Polyglot orders piece types pawn, knight, bishop, rook, queen, king
+static int polyglotKind(PieceType type, PieceColor color) {
+    constexpr int ORDER[PIECE_TYPE_COUNT] = {0, 3, 1, 2, 4, 5}; // By our PieceType
+    return 2 * ORDER[static_cast<int>(type)] + (color == PieceColor::WHITE ? 1 : 0);
+}
+
+Key polyglotKey(const Position& pos) {
+    Key key = 0;
+
+    Bitboard occupied = pos.pieces();
+    while (occupied) {
+        const int sq = popLsb(occupied);
+        PieceType type;
+        PieceColor color;
+        pos.pieceAt(sq, type, color);
+        key ^= POLYGLOT_RANDOM[64 * polyglotKind(type, color) + sq];
+    }
+
+    const int rights = pos.castlingRights();
+    if (rights & WHITE_OO) key ^= POLYGLOT_RANDOM[POLYGLOT_CASTLING_OFFSET + 0];
+    if (rights & WHITE_OOO) key ^= POLYGLOT_RANDOM[POLYGLOT_CASTLING_OFFSET + 1];
+    if (rights & BLACK_OO) key ^= POLYGLOT_RANDOM[POLYGLOT_CASTLING_OFFSET + 2];
+    if (rights & BLACK_OOO) key ^= POLYGLOT_RANDOM[POLYGLOT_CASTLING_OFFSET + 3];
+
+    // The en passant file only counts if a pawn can actually make the capture
+    const int ep = pos.enPassantSquare();
+    if (ep != NO_SQUARE &&
+        (pawnAttacks(opposite(pos.sideToMove()), ep) & pos.pieces(pos.sideToMove(), PieceType::PAWN))) {
+        key ^= POLYGLOT_RANDOM[POLYGLOT_EP_OFFSET + (ep & 7)];
+    }
+
+    if (pos.sideToMove() == PieceColor::WHITE) key ^= POLYGLOT_RANDOM[POLYGLOT_TURN_OFFSET];
+    return key;
+}
+
+bool OpeningBook::open(const std::string& path) {
+    if (!file.open(path, true)) {
+        std::cerr << "Warning: Could not map book file " << path << std::endl;
+        return false;
+    }
+    if (file.size() % ENTRY_SIZE != 0) {
+        std::cerr << "Warning: " << path << " is not a Polyglot book" << std::endl;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+// Entries are big-endian whatever the machine
+static std::uint64_t readBigEndian(const unsigned char* bytes, int count) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < count; ++i) value = (value << 8) | bytes[i];
+    return value;
+}
+
+Key OpeningBook::keyAt(std::size_t index) const {
+    return readBigEndian(file.data() + index * ENTRY_SIZE, 8);
+}
+
+std::uint16_t OpeningBook::moveAt(std::size_t index) const {
+    return static_cast<std::uint16_t>(readBigEndian(file.data() + index * ENTRY_SIZE + 8, 2));
+}
+
+std::uint16_t OpeningBook::weightAt(std::size_t index) const {
+    return static_cast<std::uint16_t>(readBigEndian(file.data() + index * ENTRY_SIZE + 10, 2));
+}
+
+// Polyglot moves are to (bits 0-5), from (6-11) and promotion piece (12-14,
+// 1 = knight ... 4 = queen); castling is written as the king taking its own rook
+static Move decodeMove(const Position& pos, std::uint16_t encoded) {
+    const int from = (encoded >> 6) & 63;
+    int to = encoded & 63;
+    const int promotion = (encoded >> 12) & 7;
+
+    if (from == pos.kingSquare(pos.sideToMove()) &&
+        (pos.pieces(pos.sideToMove(), PieceType::ROOK) & squareBB(to))) {
+        to = to > from ? from + 2 : from - 2;
+    }
+
+    constexpr PieceType PROMOTIONS[5] = {
+        PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN
+    };
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    for (Move move : moves) {
+        if (moveFrom(move) != from || moveTo(move) != to) continue;
+        if (isPromotion(move) != (promotion != 0)) continue;
+        if (promotion != 0 && (promotion > 4 || promotionType(move) != PROMOTIONS[promotion])) continue;
+        return move;
+    }
+    return NO_MOVE;
+}
+
+Move OpeningBook::probe(const Position& pos) {
+    if (!file.isOpen()) return NO_MOVE;
+
+    // First entry with our key
+    const Key key = polyglotKey(pos);
+    std::size_t low = 0;
+    std::size_t high = entryCount();
+    while (low < high) {
+        const std::size_t mid = low + (high - low) / 2;
+        if (keyAt(mid) < key) low = mid + 1;
+        else high = mid;
+    }
+
+    std::vector<Move> moves;
+    std::vector<std::uint32_t> weights;
+    std::uint32_t totalWeight = 0;
+    for (std::size_t i = low; i < entryCount() && keyAt(i) == key; ++i) {
+        const Move move = decodeMove(pos, moveAt(i));
+        if (move == NO_MOVE) continue;
+        moves.push_back(move);
+        weights.push_back(weightAt(i));
+        totalWeight += weightAt(i);
+    }
+    if (moves.empty()) return NO_MOVE;
+
+    // All weights zero: every move is equally good
+    if (totalWeight == 0) {
+        return moves[std::uniform_int_distribution<std::size_t>(0, moves.size() - 1)(rng)];
+    }
+    std::uint32_t pick = std::uniform_int_distribution<std::uint32_t>(0, totalWeight - 1)(rng);
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        if (pick < weights[i]) return moves[i];
+        pick -= weights[i];
+    }
+    return moves.back();
+}
@@ -0,0 +1,61 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include "position.h"
+#include "move.h"
+#include "mapped_file.h"
+
+// Polyglot hash of a position; differs from Position::hashKey()
+Key polyglotKey(const Position& pos);
+
+/**
+ * @brief Read-only Polyglot (.bin) opening book
+ *
+ * The file is a sorted array of 16-byte big-endian entries: key, move,
+ * weight and a learn field we ignore. It is memory-mapped instead of read,
+ * so opening a book of any size is instant, only the pages a lookup touches
+ * are loaded, and several engine processes share one copy in the page cache.
+ * A lookup is a binary search for the first entry with the position's key.
+ */
+class OpeningBook {
+public:
+    OpeningBook() : rng(std::random_device{}()) {}
+
+    /**
+     * @brief Maps a book file, closing the previous one
+     * @return False if the file cannot be mapped or is not a whole number of entries
+     */
+    bool open(const std::string& path);
+    void close() { file.close(); }
+    bool isOpen() const { return file.isOpen(); }
+    std::size_t entryCount() const { return file.size() / ENTRY_SIZE; }
+
+    /**
+     * @brief Picks a book move for the position
+     *
+     * Moves are chosen at random in proportion to their weights. Entries
+     * that do not decode to a legal move (e.g. from a key collision) are
+     * skipped.
+     * @return NO_MOVE if the position is not in the book
+     */
+    Move probe(const Position& pos);
+
+private:
+    static constexpr std::size_t ENTRY_SIZE = 16;
+
+    MappedFile file;
+    std::mt19937 rng;
+
+    Key keyAt(std::size_t index) const;
+    std::uint16_t moveAt(std::size_t index) const;
+    std::uint16_t weightAt(std::size_t index) const;
+};
+
+// The book used by the UCI "OwnBook" option
+extern OpeningBook BOOK;
+
+#endif // BOOK_H
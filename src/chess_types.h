@@ -0,0 +1,23 @@
+#ifndef CHESS_TYPES_H
+#define CHESS_TYPES_H
+
+#include <cstdint>
+#include <utility>
+
+// Piece type and color enumerations
+enum class PieceType : std::uint8_t { PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING };
+enum class PieceColor : std::uint8_t { WHITE, BLACK };
+
+// Number of piece types and colors, used to size per-piece arrays
+constexpr int PIECE_TYPE_COUNT = 6;
+constexpr int COLOR_COUNT = 2;
+
+// Coordinates on the chess board as (file, row) with row 0 at the top (rank 8)
+using BoardPosition = std::pair<int, int>;
+
+// Get the opposing color
+inline constexpr PieceColor opposite(PieceColor color) {
+    return (color == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+}
+
+#endif // CHESS_TYPES_H
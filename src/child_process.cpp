@@ -0,0 +1,229 @@
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "child_process.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// How long close() lets the process exit on its own before killing it
+constexpr int EXIT_GRACE_MS = 1000;
+
+static long long nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool ChildProcess::readLine(std::string& line, int timeoutMs) {
+    const long long deadline = nowMs() + timeoutMs;
+    for (;;) {
+        const std::size_t newline = pending.find('\n');
+        if (newline != std::string::npos) {
+            line.assign(pending, 0, newline);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            pending.erase(0, newline + 1);
+            return true;
+        }
+
+        const long long remaining = deadline - nowMs();
+        if (remaining <= 0 || !readMore(static_cast<int>(remaining))) return false;
+    }
+}
+
+#ifdef _WIN32
+
+bool ChildProcess::start(const std::string& command) {
+    close();
+
+    SECURITY_ATTRIBUTES inherit{};
+    inherit.nLength = sizeof(inherit);
+    inherit.bInheritHandle = TRUE;
+
+    HANDLE inputRead = nullptr, inputWriteEnd = nullptr, outputReadEnd = nullptr, outputWrite = nullptr;
+    if (!CreatePipe(&inputRead, &inputWriteEnd, &inherit, 0)) return false;
+    if (!CreatePipe(&outputReadEnd, &outputWrite, &inherit, 0)) {
+        CloseHandle(inputRead);
+        CloseHandle(inputWriteEnd);
+        return false;
+    }
+    // Our ends must not leak into the child
+    SetHandleInformation(inputWriteEnd, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(outputReadEnd, HANDLE_FLAG_INHERIT, 0);
+
+    STARTUPINFOA startup{};
+    startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdInput = inputRead;
+    startup.hStdOutput = outputWrite;
+    startup.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+    std::string commandLine = "cmd.exe /c " + command;
+    std::vector<char> mutableLine(commandLine.begin(), commandLine.end());
+    mutableLine.push_back('\0');
+
+    PROCESS_INFORMATION info{};
+    const BOOL started = CreateProcessA(nullptr, mutableLine.data(), nullptr, nullptr, TRUE,
+                                        CREATE_NO_WINDOW, nullptr, nullptr, &startup, &info);
+    CloseHandle(inputRead);
+    CloseHandle(outputWrite);
+    if (!started) {
+        CloseHandle(inputWriteEnd);
+        CloseHandle(outputReadEnd);
+        return false;
+    }
+    CloseHandle(info.hThread);
+
+    process = info.hProcess;
+    inputWrite = inputWriteEnd;
+    outputRead = outputReadEnd;
+    return true;
+}
+
+bool ChildProcess::writeLine(const std::string& line) {
+    if (!inputWrite) return false;
+    const std::string data = line + "\n";
+    DWORD written = 0;
+    return WriteFile(static_cast<HANDLE>(inputWrite), data.data(), static_cast<DWORD>(data.size()),
+                     &written, nullptr) && written == data.size();
+}
+
+// Anonymous pipes cannot be waited on, so poll for available bytes
+bool ChildProcess::readMore(int timeoutMs) {
+    if (!outputRead) return false;
+    const long long deadline = nowMs() + timeoutMs;
+    for (;;) {
+        DWORD available = 0;
+        if (!PeekNamedPipe(static_cast<HANDLE>(outputRead), nullptr, 0, nullptr, &available, nullptr)) {
+            return false;
+        }
+        if (available > 0) {
+            char buffer[4096];
+            DWORD got = 0;
+            const DWORD wanted = available < sizeof(buffer) ? available : static_cast<DWORD>(sizeof(buffer));
+            if (!ReadFile(static_cast<HANDLE>(outputRead), buffer, wanted, &got, nullptr) || got == 0) {
+                return false;
+            }
+            pending.append(buffer, got);
+            return true;
+        }
+        if (nowMs() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void ChildProcess::close() {
+    if (inputWrite) CloseHandle(static_cast<HANDLE>(inputWrite));
+    if (outputRead) CloseHandle(static_cast<HANDLE>(outputRead));
+    inputWrite = outputRead = nullptr;
+    if (process) {
+        if (WaitForSingleObject(static_cast<HANDLE>(process), EXIT_GRACE_MS) != WAIT_OBJECT_0) {
+            TerminateProcess(static_cast<HANDLE>(process), 1);
+        }
+        CloseHandle(static_cast<HANDLE>(process));
+        process = nullptr;
+    }
+    pending.clear();
+}
+
+#else
+
+bool ChildProcess::start(const std::string& command) {
+    close();
+
+    // A child that dies mid-write must not take us down with SIGPIPE
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // pipe() and the FD_CLOEXEC below are two steps; a fork() by another match thread in
+    // between would hand these pipes to that child, which keeps them open after exec and
+    // hides the EOF of a dead engine. Creating pipes and forking under one lock closes the gap.
+    static std::mutex forkMutex;
+    std::lock_guard<std::mutex> lock(forkMutex);
+
+    int input[2];
+    int output[2];
+    if (pipe(input) != 0) return false;
+    if (pipe(output) != 0) {
+        ::close(input[0]);
+        ::close(input[1]);
+        return false;
+    }
+
+    // Later children must not inherit these pipes either; dup2 below clears the flag for this one
+    for (int fd : {input[0], input[1], output[0], output[1]}) fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    const pid_t child = fork();
+    if (child < 0) {
+        for (int fd : {input[0], input[1], output[0], output[1]}) ::close(fd);
+        return false;
+    }
+    if (child == 0) {
+        dup2(input[0], STDIN_FILENO);
+        dup2(output[1], STDOUT_FILENO);
+        for (int fd : {input[0], input[1], output[0], output[1]}) ::close(fd);
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    ::close(input[0]);
+    ::close(output[1]);
+    pid = child;
+    inputFd = input[1];
+    outputFd = output[0];
+    return true;
+}
+
+bool ChildProcess::writeLine(const std::string& line) {
+    if (inputFd < 0) return false;
+    const std::string data = line + "\n";
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = write(inputFd, data.data() + sent, data.size() - sent);
+        if (n <= 0) return false;
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool ChildProcess::readMore(int timeoutMs) {
+    if (outputFd < 0) return false;
+    pollfd waitFor{outputFd, POLLIN, 0};
+    if (poll(&waitFor, 1, timeoutMs) <= 0) return false;
+
+    char buffer[4096];
+    const ssize_t got = read(outputFd, buffer, sizeof(buffer));
+    if (got <= 0) return false;
+    pending.append(buffer, static_cast<std::size_t>(got));
+    return true;
+}
+
+void ChildProcess::close() {
+    if (inputFd >= 0) ::close(inputFd);
+    if (outputFd >= 0) ::close(outputFd);
+    inputFd = outputFd = -1;
+    if (pid > 0) {
+        const long long deadline = nowMs() + EXIT_GRACE_MS;
+        while (waitpid(pid, nullptr, WNOHANG) == 0) {
+            if (nowMs() >= deadline) {
+                kill(pid, SIGKILL);
+                waitpid(pid, nullptr, 0);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        pid = -1;
+    }
+    pending.clear();
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef CHILD_PROCESS_H
+#define CHILD_PROCESS_H
+
+#include <string>
+
+/**
+ * @brief A program run in the background and talked to line by line
+ *
+ * The command is started through the shell (cmd.exe on Windows) with its
+ * standard input and output connected to pipes, which is all needed to
+ * drive another UCI engine. Uses fork/exec on POSIX systems and
+ * CreateProcess on Windows.
+ */
+class ChildProcess {
+public:
+    ChildProcess() = default;
+    ~ChildProcess() { close(); }
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+
+    // False if the command could not be started
+    bool start(const std::string& command);
+
+    // Sends one line (the newline is added); false once the process has gone
+    bool writeLine(const std::string& line);
+
+    /**
+     * @brief Waits up to timeoutMs for the next line of output
+     * @return False on timeout or when the process closed its output
+     */
+    bool readLine(std::string& line, int timeoutMs);
+
+    // Closes the pipes and waits briefly for the process to exit, then kills it
+    void close();
+
+private:
+    std::string pending;            // Output read but not yet returned as a line
+#ifdef _WIN32
+    void* process = nullptr;
+    void* inputWrite = nullptr;
+    void* outputRead = nullptr;
+#else
+    int pid = -1;
+    int inputFd = -1;
+    int outputFd = -1;
+#endif
+
+    // Reads what is available, waiting up to timeoutMs; false on timeout or end of output
+    bool readMore(int timeoutMs);
+};
+
+#endif // CHILD_PROCESS_H
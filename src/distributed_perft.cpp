@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include "distributed_perft.h"
+#include "movegen.h"
+#include "perft.h"
+#include "tcp_socket.h"
+
+// A worker tries to reach the coordinator this many times, this far apart, before giving up
+constexpr int WORKER_CONNECT_ATTEMPTS = 60;
+constexpr int WORKER_RETRY_MS = 2000;
+
+// How long a new connection may take to introduce itself as a worker
+constexpr int HANDSHAKE_TIMEOUT_MS = 10000;
+
+// How often the coordinator stops waiting for workers to check whether the run is done
+constexpr int ACCEPT_POLL_MS = 200;
+
+// First line of a checkpoint file, tying it to one run
+static std::string checkpointHeader(const std::string& fen, int depth, int splitDepth) {
+    return "phosphor-perft " + std::to_string(depth) + " " + std::to_string(splitDepth) + " " + fen;
+}
+
+// The FEN without its move clocks: everything perft depends on, so transpositions share a key
+static std::string subtreeKey(const Position& pos) {
+    const std::string fen = pos.toFEN();
+    std::size_t cut = fen.size();
+    for (int field = 0; field < 2 && cut != std::string::npos && cut > 0; ++field) {
+        cut = fen.rfind(' ', cut - 1);
+    }
+    return cut == std::string::npos ? fen : fen.substr(0, cut);
+}
+
+// One distinct position at the split depth, counted once however often it is reached
+struct Subtree {
+    std::string key;
+    long long nodes = -1;               // -1 until a worker (or the checkpoint) supplies it
+};
+
+// The tree down to the split depth
+struct PerftPlan {
+    MoveList rootMoves;
+    std::vector<Subtree> subtrees;
+    std::vector<std::pair<int, int>> occurrences;   // Root move index and subtree of every split node
+    std::unordered_map<std::string, int> byKey;
+};
+
+static void expandSubtrees(Position& pos, int plies, int rootIndex, PerftPlan& plan) {
+    if (plies == 0) {
+        const std::string key = subtreeKey(pos);
+        const auto [found, added] = plan.byKey.emplace(key, static_cast<int>(plan.subtrees.size()));
+        if (added) plan.subtrees.push_back({key, -1});
+        plan.occurrences.push_back({rootIndex, found->second});
+        return;
+    }
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    UndoInfo undo;
+    for (Move move : moves) {
+        pos.makeMove(move, undo);
+        expandSubtrees(pos, plies - 1, rootIndex, plan);
+        pos.unmakeMove(move, undo);
+    }
+}
+
+// Cuts off a final line that a crash left without its newline, so the lines appended next start cleanly
+static bool trimPartialLine(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return true;
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    if (text.empty() || text.back() == '\n') return true;
+
+    const std::size_t newline = text.rfind('\n');
+    std::error_code error;
+    std::filesystem::resize_file(path, newline == std::string::npos ? 0 : newline + 1, error);
+    return !error;
+}
+
+/**
+ * @brief Reads the counts of an earlier run into the plan
+ *
+ * Keys that are not part of the plan are ignored. The file must have been
+ * through trimPartialLine() first.
+ * @return False if the file belongs to a different run
+ */
+static bool loadCheckpoint(const std::string& path, const std::string& header, PerftPlan& plan) {
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line)) return true;
+    if (line != header) {
+        std::cerr << "Warning: Checkpoint '" << path << "' belongs to a different perft run" << std::endl;
+        return false;
+    }
+
+    while (std::getline(in, line)) {
+        const std::size_t space = line.find(' ');
+        if (space == std::string::npos) continue;
+        const auto found = plan.byKey.find(line.substr(space + 1));
+        if (found != plan.byKey.end()) {
+            plan.subtrees[found->second].nodes = std::atoll(line.c_str());
+        }
+    }
+    return true;
+}
+
+// Work shared between the threads serving the workers
+class CoordinatorState {
+public:
+    CoordinatorState(PerftPlan& plan, int subtreeDepth, std::ofstream* checkpoint)
+        : plan(plan), subtreeDepth(subtreeDepth), checkpoint(checkpoint),
+          startTime(std::chrono::steady_clock::now()) {
+        for (std::size_t i = 0; i < plan.subtrees.size(); ++i) {
+            if (plan.subtrees[i].nodes < 0) pending.push_back(static_cast<int>(i));
+        }
+        remaining = static_cast<int>(pending.size());
+        total = remaining;
+    }
+
+    int subtreeCount() const { return total; }
+
+    bool finished() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return remaining == 0;
+    }
+
+    // Waits for a subtree to count; false once every subtree is counted
+    bool take(int& id) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return !pending.empty() || remaining == 0; });
+        if (remaining == 0) return false;
+        id = pending.front();
+        pending.pop_front();
+        return true;
+    }
+
+    // A subtree whose worker failed goes to the front, to be counted next
+    void giveBack(int id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_front(id);
+        changed.notify_one();
+    }
+
+    void complete(int id, long long nodes, const std::string& worker) {
+        std::lock_guard<std::mutex> lock(mutex);
+        plan.subtrees[id].nodes = nodes;
+        --remaining;
+        if (checkpoint) {
+            *checkpoint << nodes << ' ' << plan.subtrees[id].key << '\n';
+            checkpoint->flush();
+        }
+
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "Subtree " << (total - remaining) << "/" << total << ": " << nodes
+                  << " nodes from " << worker << " (" << std::fixed << std::setprecision(1)
+                  << elapsed << " s)" << std::endl;
+        if (remaining == 0) changed.notify_all();
+    }
+
+    // The request line for a subtree
+    std::string request(int id) const {
+        return "perft " + std::to_string(id) + " " + std::to_string(subtreeDepth) + " " +
+               plan.subtrees[id].key + " 0 1";
+    }
+
+    // Serialized console output for the other messages of the serving threads
+    void report(const std::string& message, bool warning) {
+        std::lock_guard<std::mutex> lock(mutex);
+        (warning ? std::cerr : std::cout) << message << std::endl;
+    }
+
+private:
+    PerftPlan& plan;
+    const int subtreeDepth;
+    std::ofstream* checkpoint;
+    const std::chrono::steady_clock::time_point startTime;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<int> pending;
+    int remaining = 0;
+    int total = 0;
+};
+
+// Hands subtrees to one worker until none are left or the worker fails
+static void serveWorker(std::unique_ptr<TcpConnection> connection, CoordinatorState& state, int timeoutMs) {
+    const std::string worker = connection->peerName();
+    std::string line;
+    if (!connection->readLine(line, HANDSHAKE_TIMEOUT_MS) || line.rfind("worker", 0) != 0) {
+        state.report("Warning: " + worker + " did not introduce itself as a perft worker", true);
+        return;
+    }
+    state.report("Worker " + worker + " joined (" + line + ")", false);
+
+    int id = 0;
+    while (state.take(id)) {
+        std::istringstream reply;
+        std::string keyword;
+        int replyId = -1;
+        long long nodes = -1;
+        if (connection->writeLine(state.request(id)) && connection->readLine(line, timeoutMs)) {
+            reply.str(line);
+            reply >> keyword >> replyId >> nodes;
+        }
+        if (keyword != "nodes" || replyId != id || nodes < 0) {
+            state.giveBack(id);
+            state.report("Warning: Dropped worker " + worker + ", its subtree goes back to the queue", true);
+            return;
+        }
+        state.complete(id, nodes, worker);
+    }
+    connection->writeLine("quit");
+}
+
+bool parseDistributedPerftOptions(const std::vector<std::string>& args, DistributedPerftOptions& options) {
+    for (std::size_t i = 0; i < args.size(); i += 2) {
+        const std::string& name = args[i];
+        if (i + 1 >= args.size()) {
+            std::cerr << "Warning: Missing value for '" << name << "'" << std::endl;
+            return false;
+        }
+        const std::string& value = args[i + 1];
+
+        if (name == "depth") {
+            options.depth = std::atoi(value.c_str());
+        } else if (name == "fen") {
+            options.fen = value;
+        } else if (name == "split") {
+            options.splitDepth = std::max(1, std::atoi(value.c_str()));
+        } else if (name == "checkpoint") {
+            options.checkpoint = value;
+        } else if (name == "timeout") {
+            options.taskTimeoutSec = std::max(0, std::atoi(value.c_str()));
+        } else if (name == "host") {
+            options.host = value;
+        } else if (name == "port") {
+            options.port = std::atoi(value.c_str());
+            if (options.port < 1 || options.port > 65535) {
+                std::cerr << "Warning: Invalid port '" << value << "'" << std::endl;
+                return false;
+            }
+        } else if (name == "threads") {
+            options.threads = std::max(0, std::atoi(value.c_str()));
+        } else if (name == "hash") {
+            options.hashMB = static_cast<std::size_t>(std::max(0, std::atoi(value.c_str())));
+        } else {
+            std::cerr << "Warning: Unknown distributed perft option '" << name << "'" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool runPerftCoordinator(const DistributedPerftOptions& options) {
+    Position root;
+    if (!root.setFromFEN(options.fen)) {
+        std::cerr << "Warning: Invalid FEN '" << options.fen << "'" << std::endl;
+        return false;
+    }
+    if (options.depth < 1) {
+        std::cerr << "Warning: Perft depth must be at least 1" << std::endl;
+        return false;
+    }
+    const int splitDepth = std::min(std::max(1, options.splitDepth), options.depth);
+    const std::string rootFEN = root.toFEN();
+
+    PerftPlan plan;
+    generateLegalMoves(root, plan.rootMoves);
+    UndoInfo undo;
+    for (int i = 0; i < plan.rootMoves.size(); ++i) {
+        root.makeMove(plan.rootMoves[i], undo);
+        expandSubtrees(root, splitDepth - 1, i, plan);
+        root.unmakeMove(plan.rootMoves[i], undo);
+    }
+
+    const std::string header = checkpointHeader(rootFEN, options.depth, splitDepth);
+    std::ofstream checkpoint;
+    if (!options.checkpoint.empty()) {
+        if (!trimPartialLine(options.checkpoint)) {
+            std::cerr << "Warning: Could not repair checkpoint '" << options.checkpoint << "'" << std::endl;
+            return false;
+        }
+        if (!loadCheckpoint(options.checkpoint, header, plan)) return false;
+        std::ifstream existing(options.checkpoint);
+        const bool fresh = !existing || existing.peek() == std::ifstream::traits_type::eof();
+        existing.close();
+        checkpoint.open(options.checkpoint, std::ios::app);
+        if (!checkpoint) {
+            std::cerr << "Warning: Could not open checkpoint '" << options.checkpoint << "'" << std::endl;
+            return false;
+        }
+        if (fresh) checkpoint << header << '\n' << std::flush;
+    }
+
+    CoordinatorState state(plan, options.depth - splitDepth, checkpoint.is_open() ? &checkpoint : nullptr);
+    std::cout << "Perft " << options.depth << " of " << rootFEN << ": " << plan.occurrences.size()
+              << " nodes at split depth " << splitDepth << ", " << plan.subtrees.size() << " distinct, "
+              << state.subtreeCount() << " left to count" << std::endl;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    if (!state.finished()) {
+        TcpListener listener;
+        if (!listener.listen(options.port)) {
+            std::cerr << "Warning: Could not listen on port " << options.port << std::endl;
+            return false;
+        }
+        std::cout << "Waiting for workers on port " << options.port << std::endl;
+
+        const int timeoutMs = options.taskTimeoutSec > 0 ? options.taskTimeoutSec * 1000 : -1;
+        std::vector<std::thread> servers;
+        while (!state.finished()) {
+            auto connection = std::make_unique<TcpConnection>();
+            if (listener.accept(*connection, ACCEPT_POLL_MS)) {
+                servers.emplace_back(serveWorker, std::move(connection), std::ref(state), timeoutMs);
+            }
+        }
+        for (std::thread& server : servers) {
+            server.join();
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::vector<long long> divide(plan.rootMoves.size(), 0);
+    long long total = 0;
+    for (const auto& [rootIndex, subtree] : plan.occurrences) {
+        divide[rootIndex] += plan.subtrees[subtree].nodes;
+        total += plan.subtrees[subtree].nodes;
+    }
+
+    std::cout << "Divide at depth " << options.depth << ":" << std::endl;
+    for (int i = 0; i < plan.rootMoves.size(); ++i) {
+        std::cout << "  " << moveToUCI(plan.rootMoves[i]) << ": " << divide[i] << std::endl;
+    }
+    std::cout << "Depth " << options.depth << ": " << total << " moves (calculated in " << std::fixed
+              << std::setprecision(2) << seconds << " seconds";
+    if (seconds > 0.0 && state.subtreeCount() > 0) {
+        std::cout << ", " << static_cast<long long>(total / seconds) << " nps";
+    }
+    std::cout << ")";
+
+    const long long expected = rootFEN == START_FEN ? expectedStartPositionNodes(options.depth) : -1;
+    if (expected >= 0) {
+        std::cout << " - " << (expected == total ? "CORRECT" : "INCORRECT") << " (expected: " << expected << ")";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+bool runPerftWorker(const DistributedPerftOptions& options) {
+    if (options.host.empty()) {
+        std::cerr << "Warning: perft-worker needs the coordinator's host" << std::endl;
+        return false;
+    }
+
+    TcpConnection connection;
+    for (int attempt = 0; attempt < WORKER_CONNECT_ATTEMPTS && !connection.connect(options.host, options.port);
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(WORKER_RETRY_MS));
+    }
+    if (!connection.isOpen()) {
+        std::cerr << "Warning: Could not reach the coordinator at " << options.host << ":" << options.port << std::endl;
+        return false;
+    }
+
+    // One table and thread pool for the whole session: later subtrees reuse earlier counts
+    PerftOptions perftOptions;
+    perftOptions.threads = options.threads;
+    perftOptions.hashMB = options.hashMB;
+    PerftRunner runner(perftOptions);
+    const int threads = options.threads > 0 ? options.threads
+                                            : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    connection.writeLine("worker threads " + std::to_string(threads));
+    std::cout << "Connected to " << connection.peerName() << std::endl;
+
+    std::string line;
+    while (connection.readLine(line, -1)) {
+        if (line == "quit") {
+            std::cout << "Coordinator finished the run" << std::endl;
+            return true;
+        }
+
+        std::istringstream request(line);
+        std::string keyword, fen;
+        int id = -1;
+        int depth = -1;
+        request >> keyword >> id >> depth >> std::ws;
+        std::getline(request, fen);
+
+        Position pos;
+        if (keyword != "perft" || depth < 0 || !pos.setFromFEN(fen)) {
+            std::cerr << "Warning: Unexpected request '" << line << "'" << std::endl;
+            connection.writeLine("error " + std::to_string(id));
+            continue;
+        }
+
+        const PerftResult result = runner.run(pos, depth);
+        std::cout << "Subtree " << id << ": " << result.nodes << " nodes in " << std::fixed
+                  << std::setprecision(2) << result.seconds << " s" << std::endl;
+        if (!connection.writeLine("nodes " + std::to_string(id) + " " + std::to_string(result.nodes))) break;
+    }
+
+    std::cerr << "Warning: Lost the connection to the coordinator" << std::endl;
+    return false;
+}
@@ -0,0 +1,63 @@
+#ifndef DISTRIBUTED_PERFT_H
+#define DISTRIBUTED_PERFT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "position.h"
+
+// Port the coordinator listens on unless told otherwise
+constexpr int DEFAULT_PERFT_PORT = 7878;
+
+// Settings of a distributed perft run, for the coordinator and the workers
+struct DistributedPerftOptions {
+    // Coordinator
+    std::string fen = START_FEN;
+    int depth = 7;
+    int splitDepth = 2;                 // Plies expanded into subtrees handed to workers
+    std::string checkpoint;             // Finished subtrees are appended here and skipped on restart
+    int taskTimeoutSec = 0;             // A worker silent this long loses its subtree; 0 for no limit
+
+    // Both: the coordinator listens on port, workers connect to host:port
+    std::string host;
+    int port = DEFAULT_PERFT_PORT;
+
+    // Worker
+    int threads = 0;                    // Threads of the local perft; 0 for one per core
+    std::size_t hashMB = 64;
+};
+
+/**
+ * @brief Reads "perft-server" and "perft-worker" command-line arguments into options
+ *
+ * Keyword/value pairs: depth, fen, split, checkpoint, timeout and port for
+ * the coordinator; host, port, threads and hash for a worker.
+ * @return False (after printing a warning) on an unknown or incomplete argument
+ */
+bool parseDistributedPerftOptions(const std::vector<std::string>& args, DistributedPerftOptions& options);
+
+/**
+ * @brief Counts perft over workers on other machines and prints totals and divide
+ *
+ * The tree is expanded splitDepth plies into subtrees; positions reached by
+ * several move orders are counted once. Workers connect over TCP and are
+ * sent one subtree at a time as a FEN and depth, for as long as subtrees
+ * remain. A worker that disconnects, answers wrongly or exceeds the task
+ * timeout is dropped and its subtree goes back to the queue, so workers may
+ * come and go during the run. Every finished subtree is appended to the
+ * checkpoint file at once; restarting with the same file, position, depth
+ * and split depth only counts what is missing.
+ * @return False if the position, checkpoint or port cannot be used
+ */
+bool runPerftCoordinator(const DistributedPerftOptions& options);
+
+/**
+ * @brief Connects to a coordinator and counts the subtrees it sends with runPerft()
+ *
+ * Connection attempts are retried for a while so workers can be started
+ * before the coordinator.
+ * @return True once the coordinator reports the run finished, false if the connection fails
+ */
+bool runPerftWorker(const DistributedPerftOptions& options);
+
+#endif // DISTRIBUTED_PERFT_H
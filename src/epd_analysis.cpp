@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "epd_analysis.h"
+#include "san.h"
+#include "tt.h"
+
+// Results are flushed at least this often, so readers of a pipe see progress
+constexpr long long FLUSH_INTERVAL_MS = 1000;
+
+// One input line: the position plus the EPD operations we use
+struct EpdRecord {
+    Position pos;
+    std::string fen;
+    std::string id;
+    std::vector<std::string> bestMoves;     // "bm": any of these solves the position
+    std::vector<std::string> avoidMoves;    // "am": none of these may be played
+};
+
+static long long nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Splits "bm Nf3 e4; id \"test 1\";" into operations, keeping quoted text together
+static std::vector<std::string> splitOperations(const std::string& text) {
+    std::vector<std::string> operations;
+    std::string current;
+    bool quoted = false;
+    for (char c : text) {
+        if (c == '"') quoted = !quoted;
+        if (c == ';' && !quoted) {
+            operations.push_back(current);
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    operations.push_back(current);
+    return operations;
+}
+
+// Reads an EPD line (four FEN fields plus operations) or a full FEN line
+static bool parseEpdLine(const std::string& line, EpdRecord& record) {
+    std::istringstream stream(line);
+    std::string placement, side, castling, enPassant;
+    if (!(stream >> placement >> side >> castling >> enPassant)) return false;
+
+    // A FEN carries the move counters as two more fields, EPD as operations
+    std::string rest;
+    int halfmove = 0;
+    int fullmove = 1;
+    const std::streampos fieldsEnd = stream.tellg();
+    if (stream >> halfmove >> fullmove) {
+        std::getline(stream, rest);
+    } else {
+        halfmove = 0;
+        fullmove = 1;
+        stream.clear();
+        stream.seekg(fieldsEnd);
+        std::getline(stream, rest);
+    }
+
+    for (const std::string& operation : splitOperations(rest)) {
+        std::istringstream operands(operation);
+        std::string opcode;
+        if (!(operands >> opcode)) continue;
+
+        if (opcode == "id") {
+            const std::size_t open = operation.find('"');
+            const std::size_t close = operation.rfind('"');
+            if (open != std::string::npos && close > open) {
+                record.id = operation.substr(open + 1, close - open - 1);
+            } else {
+                operands >> record.id;
+            }
+        } else if (opcode == "bm" || opcode == "am") {
+            std::vector<std::string>& moves = (opcode == "bm") ? record.bestMoves : record.avoidMoves;
+            std::string move;
+            while (operands >> move) moves.push_back(stripSAN(move));
+        } else if (opcode == "hmvc") {
+            operands >> halfmove;
+        } else if (opcode == "fmvn") {
+            operands >> fullmove;
+        }
+    }
+
+    record.fen = placement + " " + side + " " + castling + " " + enPassant + " " +
+                 std::to_string(halfmove) + " " + std::to_string(fullmove);
+    return record.pos.setFromFEN(record.fen);
+}
+
+// -1 when the line has no bm/am operation, otherwise 1 for solved and 0 for missed
+static int gradeMove(const EpdRecord& record, Move move) {
+    if (record.bestMoves.empty() && record.avoidMoves.empty()) return -1;
+    if (move == NO_MOVE) return 0;
+
+    const std::string san = stripSAN(moveToSAN(record.pos, move));
+    const std::string uci = moveToUCI(move);
+    auto listed = [&](const std::vector<std::string>& moves) {
+        for (const std::string& m : moves) {
+            if (m == san || m == uci) return true;
+        }
+        return false;
+    };
+    if (!record.bestMoves.empty() && !listed(record.bestMoves)) return 0;
+    return listed(record.avoidMoves) ? 0 : 1;
+}
+
+static std::string pvText(const std::vector<Move>& pv) {
+    std::string text;
+    for (Move move : pv) {
+        if (!text.empty()) text += ' ';
+        text += moveToUCI(move);
+    }
+    return text;
+}
+
+// Quotes a CSV field when it holds a separator or a quote
+static std::string csvField(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) return text;
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+static std::string jsonString(const std::string& text) {
+    std::string escaped = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) escaped += c;
+    }
+    return escaped + "\"";
+}
+
+static const char* CSV_HEADER = "line,id,fen,best_move,score,mate,depth,nodes,time_ms,pv,solved";
+
+static std::string formatResult(const std::string& format, long long lineNumber,
+                                const EpdRecord& record, const SearchResult& result, int grade) {
+    const bool isMate = isMateScore(result.score);
+    const int mate = mateIn(result.score);
+    std::ostringstream out;
+
+    if (format == "json") {
+        out << "{\"line\":" << lineNumber
+            << ",\"id\":" << jsonString(record.id)
+            << ",\"fen\":" << jsonString(record.fen)
+            << ",\"best_move\":\"" << moveToUCI(result.bestMove) << "\""
+            << ",\"score\":" << result.score
+            << ",\"mate\":" << (isMate ? std::to_string(mate) : "null")
+            << ",\"depth\":" << result.depth
+            << ",\"nodes\":" << result.nodes
+            << ",\"time_ms\":" << result.timeMs
+            << ",\"pv\":\"" << pvText(result.pv) << "\""
+            << ",\"solved\":" << (grade < 0 ? "null" : (grade ? "true" : "false")) << "}\n";
+    } else {
+        out << lineNumber << "," << csvField(record.id) << "," << record.fen << ","
+            << moveToUCI(result.bestMove) << "," << result.score << ","
+            << (isMate ? std::to_string(mate) : "") << "," << result.depth << ","
+            << result.nodes << "," << result.timeMs << "," << pvText(result.pv) << ","
+            << (grade < 0 ? "" : std::to_string(grade)) << "\n";
+    }
+    return out.str();
+}
+
+// State shared by the worker threads of one run
+struct BatchRun {
+    const BatchOptions& options;
+    std::istream& in;
+    std::ostream& out;
+
+    std::mutex inputMutex;
+    long long linesRead = 0;
+
+    std::mutex outputMutex;
+    long long lastFlushMs = 0;
+
+    std::atomic<long long> analyzed{0};
+    std::atomic<long long> skipped{0};
+    std::atomic<long long> nodes{0};
+    std::atomic<long long> graded{0};
+    std::atomic<long long> solved{0};
+
+    BatchRun(const BatchOptions& opts, std::istream& input, std::ostream& output)
+        : options(opts), in(input), out(output) {}
+};
+
+static void batchWorker(BatchRun& run) {
+    std::string line;
+    for (;;) {
+        long long lineNumber;
+        {
+            std::lock_guard<std::mutex> lock(run.inputMutex);
+            if (!std::getline(run.in, line)) return;
+            lineNumber = ++run.linesRead;
+        }
+
+        const std::size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        EpdRecord record;
+        if (!parseEpdLine(line, record)) {
+            run.skipped++;
+            std::lock_guard<std::mutex> lock(run.outputMutex);
+            std::cerr << "Warning: Skipping line " << lineNumber << ", not a valid EPD or FEN" << std::endl;
+            continue;
+        }
+
+        const SearchResult result = searchPosition(record.pos, run.options.limits);
+        const int grade = gradeMove(record, result.bestMove);
+        const std::string text = formatResult(run.options.format, lineNumber, record, result, grade);
+
+        run.analyzed++;
+        run.nodes += result.nodes;
+        if (grade >= 0) {
+            run.graded++;
+            run.solved += grade;
+        }
+
+        std::lock_guard<std::mutex> lock(run.outputMutex);
+        run.out << text;
+        const long long now = nowMs();
+        if (now - run.lastFlushMs >= FLUSH_INTERVAL_MS) {
+            run.out.flush();
+            run.lastFlushMs = now;
+        }
+    }
+}
+
+bool parseBatchOptions(const std::vector<std::string>& args, BatchOptions& options) {
+    if (args.empty()) {
+        std::cerr << "Warning: analyze needs an input file (or - for stdin)" << std::endl;
+        return false;
+    }
+    options.input = args[0];
+
+    bool limited = false;
+    for (std::size_t i = 1; i < args.size(); i += 2) {
+        const std::string& name = args[i];
+        if (i + 1 >= args.size()) {
+            std::cerr << "Warning: Missing value for '" << name << "'" << std::endl;
+            return false;
+        }
+        const std::string& value = args[i + 1];
+
+        if (name == "depth") {
+            options.limits.depth = std::max(1, std::min(std::atoi(value.c_str()), MAX_PLY - 1));
+            limited = true;
+        } else if (name == "nodes") {
+            options.limits.nodes = std::atoll(value.c_str());
+            limited = true;
+        } else if (name == "movetime") {
+            options.limits.moveTime = std::atoi(value.c_str());
+            limited = true;
+        } else if (name == "threads") {
+            options.threads = std::atoi(value.c_str());
+        } else if (name == "hash") {
+            options.hashMB = std::atoi(value.c_str());
+        } else if (name == "format") {
+            if (value != "csv" && value != "json") {
+                std::cerr << "Warning: Unknown format '" << value << "', expected csv or json" << std::endl;
+                return false;
+            }
+            options.format = value;
+        } else if (name == "output") {
+            options.output = value;
+        } else {
+            std::cerr << "Warning: Unknown analyze option '" << name << "'" << std::endl;
+            return false;
+        }
+    }
+
+    if (!limited) options.limits.depth = DEFAULT_BATCH_DEPTH;
+    return true;
+}
+
+bool runBatchAnalysis(const BatchOptions& options) {
+    std::ifstream inputFile;
+    if (options.input != "-") {
+        inputFile.open(options.input);
+        if (!inputFile) {
+            std::cerr << "Warning: Could not open input file '" << options.input << "'" << std::endl;
+            return false;
+        }
+    }
+    std::ofstream outputFile;
+    if (!options.output.empty()) {
+        outputFile.open(options.output);
+        if (!outputFile) {
+            std::cerr << "Warning: Could not open output file '" << options.output << "'" << std::endl;
+            return false;
+        }
+    }
+    std::istream& in = inputFile.is_open() ? static_cast<std::istream&>(inputFile) : std::cin;
+    std::ostream& out = outputFile.is_open() ? static_cast<std::ostream&>(outputFile) : std::cout;
+
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, MAX_SEARCH_THREADS));
+    if (options.hashMB > 0) TT.resize(static_cast<std::size_t>(options.hashMB));
+
+    // Independent single-threaded searches scale better than Lazy SMP on each
+    const int savedThreads = getSearchThreads();
+    setSearchThreads(1);
+    prepareSearch(false);
+
+    if (options.format == "csv") out << CSV_HEADER << "\n";
+
+    BatchRun run(options, in, out);
+    run.lastFlushMs = nowMs();
+    const long long startMs = run.lastFlushMs;
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(batchWorker, std::ref(run));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    out.flush();
+    setSearchThreads(savedThreads);
+
+    const double seconds = (nowMs() - startMs) / 1000.0;
+    std::cerr << std::fixed << std::setprecision(2)
+              << "Analyzed " << run.analyzed << " positions (" << run.skipped << " skipped) in "
+              << seconds << " s on " << threads << " threads, " << run.nodes << " nodes ("
+              << (seconds > 0.0 ? static_cast<long long>(run.nodes / seconds) : 0) << " nps)" << std::endl;
+    if (run.graded > 0) {
+        std::cerr << "Solved " << run.solved << " of " << run.graded << " graded positions" << std::endl;
+    }
+    std::cerr.unsetf(std::ios::floatfield);
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef EPD_ANALYSIS_H
+#define EPD_ANALYSIS_H
+
+#include <string>
+#include <vector>
+#include "search.h"
+
+// Depth used when no depth, node or time limit is given
+constexpr int DEFAULT_BATCH_DEPTH = 10;
+
+// Settings of one batch analysis run
+struct BatchOptions {
+    std::string input = "-";            // EPD or FEN file, "-" for stdin
+    std::string output;                 // Result file, empty for stdout
+    std::string format = "csv";         // "csv" or "json" (one object per line)
+    SearchLimits limits;                // Depth, nodes and/or movetime per position
+    int threads = 0;                    // Positions searched at the same time; 0 for one per core
+    int hashMB = 0;                     // Hash table size; 0 keeps the current one
+};
+
+/**
+ * @brief Reads "analyze" command-line arguments into options
+ *
+ * Expects the input path followed by keyword/value pairs: depth, nodes,
+ * movetime, threads, hash, format and output. Without any search limit the
+ * depth defaults to DEFAULT_BATCH_DEPTH.
+ * @return False (after printing a warning) on an unknown or incomplete argument
+ */
+bool parseBatchOptions(const std::vector<std::string>& args, BatchOptions& options);
+
+/**
+ * @brief Analyzes every position of an EPD or FEN stream
+ *
+ * Lines are read one at a time by a pool of worker threads, each running a
+ * single-threaded search, so memory use does not grow with the input and
+ * the whole machine is busy. All searches share the transposition table,
+ * which is kept between positions. A result line (best move, score, depth,
+ * nodes, time and PV) is written as soon as its position is done, so the
+ * output is in completion order; its "line" field gives the input line.
+ * EPD "bm" and "am" operations are compared with the best move, making the
+ * output usable for grading test suites. Blank lines and lines starting
+ * with '#' are skipped, unparsable ones are skipped with a warning.
+ * @return False if the input or output could not be opened
+ */
+bool runBatchAnalysis(const BatchOptions& options);
+
+#endif // EPD_ANALYSIS_H
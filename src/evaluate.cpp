@@ -0,0 +1,22 @@
+#include <algorithm>
+#include "evaluate.h"
+
+// Bonus for keeping both bishops
+constexpr Score BISHOP_PAIR_BONUS = makeScore(30, 50);
+
+// Bonus for having the move
+constexpr int TEMPO_BONUS = 10;
+
+int evaluate(const Position& pos) {
+    // Material and piece placement are summed incrementally by makeMove
+    Score score = pos.psqScore();
+
+    if (moreThanOne(pos.pieces(PieceColor::WHITE, PieceType::BISHOP))) score += BISHOP_PAIR_BONUS;
+    if (moreThanOne(pos.pieces(PieceColor::BLACK, PieceType::BISHOP))) score -= BISHOP_PAIR_BONUS;
+
+    // Blend middlegame and endgame by the material left (promotions can push the phase past the maximum)
+    const int phase = std::min(pos.gamePhase(), MAX_PHASE);
+    const int blended = (mgValue(score) * phase + egValue(score) * (MAX_PHASE - phase)) / MAX_PHASE;
+
+    return (pos.sideToMove() == PieceColor::WHITE ? blended : -blended) + TEMPO_BONUS;
+}
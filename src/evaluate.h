@@ -0,0 +1,17 @@
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+#include "position.h"
+
+// Piece values in centipawns, indexed by PieceType (for move ordering; the evaluation uses the PSQT)
+constexpr int PIECE_VALUES[PIECE_TYPE_COUNT] = {100, 500, 320, 330, 900, 0};
+
+/**
+ * @brief Static evaluation in centipawns from the side to move's point of view
+ *
+ * Tapers the position's incrementally updated middlegame and endgame
+ * piece-square sums by game phase, so a call costs a handful of operations.
+ */
+int evaluate(const Position& pos);
+
+#endif // EVALUATE_H
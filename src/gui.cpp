@@ -4,6 +4,7 @@
 #include "pieces_placement.h"
 #include "pieces_movment.h"
 #include "game_logic.h"
+#include "search.h"
 
 // Constants for chess board configuration
 const unsigned int BOARD_SIZE = 8;
@@ -20,10 +21,10 @@ const std::string ChessBoard::INITIAL_POSITION_FEN = "rnbqkbnr/pppppppp/8/8/8/8/
 // Implementation of the ChessBoard class
 ChessBoard::ChessBoard() : 
     currentFEN(INITIAL_POSITION_FEN),
+    boardDirty(true),
     frameCounter(0),
     frameTimeAccumulator(0.0f),
     deltaTime(0.0f),
-    redrawBoardPiecesTexture(true),
     newGameHovered(false),
     resetHovered(false),
     window(sf::VideoMode(WINDOW_SIZE, WINDOW_SIZE), 
@@ -33,15 +34,10 @@ ChessBoard::ChessBoard() :
 }
 
 bool ChessBoard::initialize(float pieceScaleFactor) {
-    // Set up window with vsync and anti-aliasing
-    sf::ContextSettings settings;
-    settings.antialiasingLevel = 8;
+    // Set up window with vsync
     window.setVerticalSyncEnabled(true);
     window.setFramerateLimit(60);
     
-    // Create board texture and intermediate render textures for better performance
-    createBoardTexture();
-    
     // Setup game control buttons
     setupButtons();
     
@@ -52,13 +48,13 @@ bool ChessBoard::initialize(float pieceScaleFactor) {
                   << "Required naming format: white-rook.png, black-knight.png, etc." << std::endl;
         return false;
     }
+    const auto& textureManager = PieceTextureManager::getInstance();
+    boardBatch.setTexture(&textureManager.getAtlas(), textureManager.getSolidRect());
     
-    // Setup initial position
+    // Create game logic and set up the initial position
+    gameLogic = std::make_unique<ChessGameLogic>();
     setPosition(currentFEN);
     
-    // Create game logic
-    gameLogic = std::make_unique<ChessGameLogic>(pieces);
-    
     // Initialize interaction handler
     interaction = std::make_unique<ChessInteraction>(pieces, *gameLogic, SQUARE_SIZE);
     
@@ -68,17 +64,8 @@ bool ChessBoard::initialize(float pieceScaleFactor) {
     // Start the clock
     clock.restart();
     
-    // Create a render texture for caching the board + pieces
-    if (!boardPiecesTexture.create(WINDOW_SIZE, WINDOW_SIZE, settings)) {
-        std::cerr << "Error: Could not create board pieces texture." << std::endl;
-        return false;
-    }
-    
-    // Create a sprite for the cached board + pieces
-    boardPiecesSprite.setTexture(boardPiecesTexture.getTexture());
-    
-    // Force initial render of the board + pieces
-    redrawBoardPiecesTexture = true;
+    // Force initial build of the board batch
+    boardDirty = true;
     
     return true;
 }
@@ -135,70 +122,120 @@ bool ChessBoard::handleButtonClick(int x, int y) {
     // Check if new game button was clicked
     if (isPointInButton(x, y, newGameButton)) {
         // Reset the game
+        gameLogic = std::make_unique<ChessGameLogic>();
         setPosition(INITIAL_POSITION_FEN);
-        gameLogic = std::make_unique<ChessGameLogic>(pieces);
         interaction = std::make_unique<ChessInteraction>(pieces, *gameLogic, SQUARE_SIZE);
-        redrawBoardPiecesTexture = true;
+        boardDirty = true;
         return true;
     }
     
     // Check if reset button was clicked
     if (isPointInButton(x, y, resetButton)) {
         // Reset the current game
-        gameLogic->resetGame();
+        interaction->resetGame();
         interaction = std::make_unique<ChessInteraction>(pieces, *gameLogic, SQUARE_SIZE);
-        redrawBoardPiecesTexture = true;
+        sendPositionToAnalysis();
+        boardDirty = true;
         return true;
     }
     
     return false;
 }
 
-void ChessBoard::createBoardTexture() {
-    // Create render texture for the board
-    if (!boardTexture.create(WINDOW_SIZE, WINDOW_SIZE)) {
-        std::cerr << "Error: Could not create board texture." << std::endl;
-        return;
-    }
-    
-    // Start drawing to the texture
-    boardTexture.clear(BACKGROUND);
+void ChessBoard::rebuildBoardBatch() {
+    boardBatch.clear();
     
     // Draw the checkerboard pattern
-    sf::RectangleShape square(sf::Vector2f(SQUARE_SIZE, SQUARE_SIZE));
-    
     for (unsigned int row = 0; row < BOARD_SIZE; ++row) {
         for (unsigned int col = 0; col < BOARD_SIZE; ++col) {
-            // Determine square color
-            square.setFillColor(((row + col) % 2 == 0) ? LIGHT_SQUARE : DARK_SQUARE);
-            
-            // Position the square
-            square.setPosition(col * SQUARE_SIZE, row * SQUARE_SIZE);
-            
-            // Draw the square
-            boardTexture.draw(square);
+            boardBatch.addRect(sf::FloatRect(col * SQUARE_SIZE, row * SQUARE_SIZE, SQUARE_SIZE, SQUARE_SIZE),
+                               ((row + col) % 2 == 0) ? LIGHT_SQUARE : DARK_SQUARE);
         }
     }
     
-    // Finish drawing
-    boardTexture.display();
+    // Highlight the engine's best move while analysing
+    appendAnalysisMove();
     
-    // Set up the sprite
-    boardSprite.setTexture(boardTexture.getTexture());
+    // Pieces, then interaction elements (selection, legal moves, etc.) on top
+    appendPieces(boardBatch, pieces);
+    interaction->appendTo(boardBatch);
 }
 
 void ChessBoard::setPosition(const std::string& fen) {
     // Store the current FEN
     currentFEN = fen;
     
-    // Clear the current pieces
-    pieces.clear();
-    
-    // Set up new position
-    setupPositionFromFEN(pieces, fen);
+    // Set up the new position and mirror it into the sprite map
+    gameLogic->setupFromFEN(fen);
+    syncPiecesFromPosition(pieces, gameLogic->getPosition());
+    sendPositionToAnalysis();
     
     // Flag the board pieces texture for redraw
-    redrawBoardPiecesTexture = true;
+    boardDirty = true;
+}
+
+void ChessBoard::sendPositionToAnalysis() {
+    // The engine wants the positions before the current one
+    std::vector<Key> history = gameLogic->getPositionHistory();
+    if (!history.empty()) history.pop_back();
+    analysis.setPosition(gameLogic->getPosition(), history);
+    analysedKey = gameLogic->getPosition().hashKey();
+    analysedPlies = gameLogic->getPositionHistory().size();
+    hasAnalysis = false;
+    boardDirty = true;
+    updateWindowTitle();
+}
+
+void ChessBoard::toggleAnalysis() {
+    if (analysis.isRunning()) {
+        analysis.stop();
+    } else {
+        analysis.start();
+    }
+    hasAnalysis = false;
+    boardDirty = true;
+    updateWindowTitle();
+}
+
+void ChessBoard::updateAnalysis() {
+    // Never blocks: takes whatever the engine thread has sent since the last frame
+    if (analysis.poll(latestAnalysis)) {
+        hasAnalysis = true;
+        boardDirty = true;
+        updateWindowTitle();
+    }
+}
+
+void ChessBoard::updateWindowTitle() {
+    std::string title = "Chess Board - FPS: " + std::to_string(displayedFps);
+    if (analysis.isRunning() || hasAnalysis) {
+        title += " | Analysis";
+        if (hasAnalysis) {
+            title += " depth " + std::to_string(latestAnalysis.depth) + " " + scoreToUCI(latestAnalysis.score) + " " +
+                     std::to_string(latestAnalysis.nps / 1000) + " knps:";
+
+            // The first few moves of the line are all that fit
+            const std::size_t shown = latestAnalysis.pv.size() < 8 ? latestAnalysis.pv.size() : 8;
+            for (std::size_t i = 0; i < shown; ++i) {
+                title += " " + moveToUCI(latestAnalysis.pv[i]);
+            }
+        } else {
+            title += " (thinking...)";
+        }
+    }
+    window.setTitle(title);
+}
+
+void ChessBoard::appendAnalysisMove() {
+    if (!hasAnalysis || latestAnalysis.bestMove == NO_MOVE) return;
+
+    // Tint the best move's origin and destination squares
+    const sf::Color tint(70, 130, 220, 110);
+    for (int sq : {moveFrom(latestAnalysis.bestMove), moveTo(latestAnalysis.bestMove)}) {
+        const BoardPosition boardPos = toBoardPosition(sq);
+        boardBatch.addRect(sf::FloatRect(boardPos.first * SQUARE_SIZE, boardPos.second * SQUARE_SIZE,
+                                         SQUARE_SIZE, SQUARE_SIZE), tint);
+    }
 }
 
 void ChessBoard::handleEvents() {
@@ -244,12 +281,19 @@ void ChessBoard::handleEvents() {
         } else if (event.type == sf::Event::MouseMoved) {
             // Update button hover states
             updateButtonHoverStates(event.mouseMove.x, event.mouseMove.y);
+        } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::A) {
+            toggleAnalysis();
         }
     }
     
-    // If the board changed, flag for redraw
+    // If the board changed, flag for redraw; selecting a piece or opening the
+    // promotion panel leaves the position alone, so only a move restarts the analysis
     if (boardChanged) {
-        redrawBoardPiecesTexture = true;
+        boardDirty = true;
+        if (gameLogic->getPosition().hashKey() != analysedKey ||
+            gameLogic->getPositionHistory().size() != analysedPlies) {
+            sendPositionToAnalysis();
+        }
     }
 }
 
@@ -262,33 +306,23 @@ void ChessBoard::update() {
     
     // Update game state display
     updateGameStateDisplay();
+    
+    // Pick up new analysis results
+    updateAnalysis();
 }
 
 void ChessBoard::render() {
     // Clear the window
     window.clear(BACKGROUND);
     
-    // If the board or pieces changed, redraw the cached texture
-    if (redrawBoardPiecesTexture) {
-        boardPiecesTexture.clear(BACKGROUND);
-        
-        // Draw the board
-        boardPiecesTexture.draw(boardSprite);
-        
-        // Draw pieces
-        for (const auto& [pos, piece] : pieces) {
-            boardPiecesTexture.draw(piece.sprite);
-        }
-        
-        boardPiecesTexture.display();
-        redrawBoardPiecesTexture = false;
+    // Rebuild the batch only when the board changed or the selection is pulsing
+    if (boardDirty || interaction->isAnimating()) {
+        rebuildBoardBatch();
+        boardDirty = false;
     }
     
-    // Draw the cached board + pieces
-    window.draw(boardPiecesSprite);
-    
-    // Draw interaction elements (selection, legal moves, etc.)
-    interaction->draw(window);
+    // Board, pieces and highlights in a single draw call
+    boardBatch.draw(window);
     
     // Draw UI elements
     drawUI();
@@ -406,7 +440,8 @@ void ChessBoard::run() {
         frameTimeAccumulator += deltaTime;
         if (frameTimeAccumulator >= 1.0f) {
             float fps = static_cast<float>(frameCounter) / frameTimeAccumulator;
-            window.setTitle("Chess Board - FPS: " + std::to_string(static_cast<int>(fps)));
+            displayedFps = static_cast<int>(fps);
+            updateWindowTitle();
             frameCounter = 0;
             frameTimeAccumulator = 0.0f;
         }
@@ -8,6 +8,7 @@
 #include "pieces_placement.h"
 #include "pieces_movment.h"
 #include "game_logic.h"
+#include "analysis.h"
 
 // Color constants for UI
 const sf::Color BUTTON_COLOR(60, 60, 90, 200);
@@ -37,13 +38,11 @@ private:
     // Board state
     std::map<std::pair<int, int>, ChessPiece> pieces;
     std::string currentFEN;
-    sf::RenderTexture boardTexture;
-    sf::Sprite boardSprite;
     
-    // Optimization - cached rendering of board and pieces
-    sf::RenderTexture boardPiecesTexture;
-    sf::Sprite boardPiecesSprite;
-    bool redrawBoardPiecesTexture;
+    // Board squares, pieces and highlights in one vertex array drawn with the
+    // piece atlas; rebuilt only on frames where something changed
+    SpriteBatch boardBatch;
+    bool boardDirty;
     
     // Performance tracking
     int frameCounter;
@@ -74,8 +73,16 @@ private:
     GameState currentDisplayState = GameState::ACTIVE;
     PieceColor currentDisplayTurn = PieceColor::WHITE;
     
+    // Live analysis ('A' toggles it), searched on the engine's own thread
+    AnalysisEngine analysis;
+    AnalysisUpdate latestAnalysis;
+    bool hasAnalysis = false;
+    Key analysedKey = 0;                // Position last sent to the analysis, and its game length
+    std::size_t analysedPlies = 0;
+    int displayedFps = 0;
+    
     // Private methods
-    void createBoardTexture();
+    void rebuildBoardBatch();
     void drawUI();
     void setupButtons();
     void handleEvents();
@@ -86,6 +93,11 @@ private:
     void updateButtonHoverStates(int mouseX, int mouseY);
     void initializeGameStateDisplay();
     void updateGameStateDisplay();
+    void toggleAnalysis();
+    void sendPositionToAnalysis();
+    void updateAnalysis();
+    void appendAnalysisMove();
+    void updateWindowTitle();
 
 public:
     ChessBoard();
@@ -1,19 +1,93 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#ifndef NO_GUI
 #include "gui.h"
-#include "search.h"
+#endif
+#include "perft.h"
+#include "attacks.h"
+#include "zobrist.h"
+#include "nnue.h"
+#include "uci.h"
+#include "bench.h"
+#include "epd_analysis.h"
+#include "pgn.h"
+#include "selfplay.h"
+#include "distributed_perft.h"
 
-// Forward declaration of the new search functions
-void calculateMovesForPosition(const std::string& fen);
-void calculateMovesForStartingPosition();
+// Ask the user for a perft depth
+static int readDepth() {
+    int depth = 0;
+    std::cout << "Enter depth (1-8): ";
+    std::cin >> depth;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    return (depth < 1) ? 1 : (depth > 8 ? 8 : depth);
+}
+
+int main(int argc, char* argv[]) {
+    initAttacks();
+    initZobristKeys();
+
+    // A network in the working directory replaces the classical evaluation
+    if (std::ifstream(DEFAULT_EVAL_FILE).good()) {
+        loadNetwork(DEFAULT_EVAL_FILE);
+    }
+
+    // "main uci" starts straight in engine mode for match runners and GUIs
+    if (argc > 1 && std::string(argv[1]) == "uci") {
+        runUCI(false);
+        return 0;
+    }
+
+    // "main bench [depth] [human|json|csv]" runs the fixed benchmark suite and exits
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        const int depth = (argc > 2) ? std::atoi(argv[2]) : DEFAULT_BENCH_DEPTH;
+        const std::string format = (argc > 3) ? argv[3] : "human";
+        return runBench(depth, format) ? 0 : 1;
+    }
+
+    // "main analyze <file|-> [depth N] [nodes N] [movetime N] [threads N] [hash N]
+    // [format csv|json] [output path]" analyzes every position of an EPD/FEN file and exits
+    if (argc > 1 && std::string(argv[1]) == "analyze") {
+        BatchOptions options;
+        if (!parseBatchOptions(std::vector<std::string>(argv + 2, argv + argc), options)) return 1;
+        return runBatchAnalysis(options) ? 0 : 1;
+    }
+
+    // "main pgn <file> [threads]" parses and replays every game of a PGN database and exits
+    if (argc > 2 && std::string(argv[1]) == "pgn") {
+        const int threads = (argc > 3) ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+        return runPgnReplay(argv[2], threads) ? 0 : 1;
+    }
+
+    // "main selfplay [games N] [concurrency N] [tc base+inc] [engine1 spec] [engine2 spec] ..."
+    // plays a match between two engine configurations and exits
+    if (argc > 1 && std::string(argv[1]) == "selfplay") {
+        SelfPlayOptions options;
+        if (!parseSelfPlayOptions(std::vector<std::string>(argv + 2, argv + argc), options)) return 1;
+        return runSelfPlay(options) ? 0 : 1;
+    }
+
+    // "main perft-server [depth N] [fen F] [split N] [port N] [checkpoint path] [timeout S]" counts
+    // perft on the workers that connect; "main perft-worker host H [port N] [threads N] [hash N]"
+    // is one of them
+    if (argc > 1 && (std::string(argv[1]) == "perft-server" || std::string(argv[1]) == "perft-worker")) {
+        DistributedPerftOptions options;
+        if (!parseDistributedPerftOptions(std::vector<std::string>(argv + 2, argv + argc), options)) return 1;
+        const bool ok = std::string(argv[1]) == "perft-server" ? runPerftCoordinator(options)
+                                                                : runPerftWorker(options);
+        return ok ? 0 : 1;
+    }
 
-int main() {
     std::cout << "Chess Application\n";
     std::cout << "================\n\n";
     
     int choice = 0;
     std::string fen;
+    std::string input;
     
     while (choice != 4) {
         std::cout << "Choose an option:\n";
@@ -22,23 +96,31 @@ int main() {
         std::cout << "3. Calculate custom position (you can choose depth)\n";
         std::cout << "4. Exit\n";
         std::cout << "Enter your choice (1-4): ";
-        std::cin >> choice;
-        
-        // Clear any remaining input in buffer
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        if (!std::getline(std::cin, input)) break;
+
+        // A UCI GUI talking to the menu switches the program to engine mode
+        if (input == "uci") {
+            runUCI(true);
+            return 0;
+        }
+        choice = std::atoi(input.c_str());
         
         switch (choice) {
             case 1:
+#ifndef NO_GUI
                 // Start the chess application with main menu
                 startChessApplication();
+#else
+                std::cout << "This is the headless build; build with 'make' for the GUI.\n";
+#endif
                 break;
             case 2:
-                calculateMovesForStartingPosition();
+                calculateMovesForStartingPosition(readDepth());
                 break;
             case 3:
                 std::cout << "Enter FEN position: ";
                 std::getline(std::cin, fen);
-                calculateMovesForPosition(fen);
+                calculateMovesForPosition(fen, readDepth());
                 break;
             case 4:
                 std::cout << "Exiting...\n";
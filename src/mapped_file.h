@@ -0,0 +1,43 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief A whole file mapped read-only into memory
+ *
+ * Nothing is read up front: pages are loaded on first access and stay in
+ * the operating system's page cache, shared with every other process that
+ * maps the same file. Uses mmap on POSIX systems and a file mapping on
+ * Windows.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps a file, unmapping the previous one
+     * @param randomAccess Hints that reads will jump around, so read-ahead is wasted
+     * @return False if the file cannot be opened or mapped, or is empty
+     */
+    bool open(const std::string& path, bool randomAccess);
+    void close();
+
+    bool isOpen() const { return bytes != nullptr; }
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+    const unsigned char* bytes = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,73 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include <string>
+#include "bitboard.h"
+
+/**
+ * @brief A move packed into 16 bits
+ *
+ * Bits 0-5 hold the origin square, bits 6-11 the destination square and
+ * bits 12-15 the move flags below. Bit 2 of the flags marks captures and
+ * bit 3 marks promotions, with the promotion piece in the low two bits.
+ */
+using Move = std::uint16_t;
+
+// a1a1 can never be a legal move, so it doubles as "no move"
+constexpr Move NO_MOVE = 0;
+
+enum MoveFlag : std::uint16_t {
+    QUIET             = 0,
+    DOUBLE_PUSH       = 1,
+    KING_CASTLE       = 2,
+    QUEEN_CASTLE      = 3,
+    CAPTURE           = 4,
+    EP_CAPTURE        = 5,
+    PROMOTION         = 8,  // + 0 knight, 1 bishop, 2 rook, 3 queen
+    PROMOTION_CAPTURE = 12
+};
+
+inline constexpr Move makeMove(int from, int to, int flags = QUIET) {
+    return static_cast<Move>(from | (to << 6) | (flags << 12));
+}
+
+inline constexpr int moveFrom(Move m) { return m & 63; }
+inline constexpr int moveTo(Move m) { return (m >> 6) & 63; }
+inline constexpr int moveFlags(Move m) { return m >> 12; }
+inline constexpr bool isCapture(Move m) { return (moveFlags(m) & CAPTURE) != 0; }
+inline constexpr bool isPromotion(Move m) { return (moveFlags(m) & PROMOTION) != 0; }
+inline constexpr bool isEnPassant(Move m) { return moveFlags(m) == EP_CAPTURE; }
+inline constexpr bool isCastling(Move m) {
+    return moveFlags(m) == KING_CASTLE || moveFlags(m) == QUEEN_CASTLE;
+}
+
+// Piece a promotion move promotes to
+inline constexpr PieceType promotionType(Move m) {
+    constexpr PieceType types[4] = {
+        PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN
+    };
+    return types[moveFlags(m) & 3];
+}
+
+// Flag bits for promoting to the given piece (knight, bishop, rook or queen)
+inline constexpr int promotionFlags(PieceType type) {
+    switch (type) {
+        case PieceType::KNIGHT: return PROMOTION | 0;
+        case PieceType::BISHOP: return PROMOTION | 1;
+        case PieceType::ROOK:   return PROMOTION | 2;
+        default:                return PROMOTION | 3;
+    }
+}
+
+// Long algebraic notation as used by UCI ("e2e4", "e7e8q")
+inline std::string moveToUCI(Move m) {
+    if (m == NO_MOVE) return "0000";
+    std::string text = squareName(moveFrom(m)) + squareName(moveTo(m));
+    if (isPromotion(m)) {
+        text += "nbrq"[moveFlags(m) & 3];
+    }
+    return text;
+}
+
+#endif // MOVE_H
@@ -0,0 +1,227 @@
+#include "movegen.h"
+
+// Add a move for each promotion piece, queen first for better ordering
+static void addPromotions(MoveList& list, int from, int to, int captureFlag) {
+    for (PieceType type : {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT}) {
+        list.add(makeMove(from, to, promotionFlags(type) | captureFlag));
+    }
+}
+
+// Add moves from one square to every square in a target set
+static void addMoves(MoveList& list, int from, Bitboard targets, Bitboard enemies) {
+    while (targets) {
+        const int to = popLsb(targets);
+        list.add(makeMove(from, to, (enemies & squareBB(to)) ? CAPTURE : QUIET));
+    }
+}
+
+// Everything the generators need to know about checks and pins. The
+// generators are instantiated per side to move, so no color test is left
+// in their loops.
+struct GenContext {
+    int kingSq;
+    Bitboard own;
+    Bitboard enemies;
+    Bitboard occupied;
+    Bitboard checkers;
+    Bitboard pinned;        // Our pieces that may only move along the line to our king
+    Bitboard checkMask;     // Squares a non-king move must land on (all squares when not in check)
+    bool tactical;          // Stage includes captures and promotions
+    bool quiet;             // Stage includes quiet moves
+};
+
+template <PieceColor Us>
+static GenContext makeContext(const Position& pos, GenType type) {
+    constexpr PieceColor Them = opposite(Us);
+    GenContext ctx;
+    ctx.kingSq = pos.kingSquare(Us);
+    ctx.own = pos.pieces(Us);
+    ctx.enemies = pos.pieces(Them);
+    ctx.occupied = ctx.own | ctx.enemies;
+    ctx.checkers = pos.attackersTo(ctx.kingSq, ctx.occupied) & ctx.enemies;
+    ctx.tactical = (type != QUIETS);
+    ctx.quiet = (type != CAPTURES);
+
+    // Enemy sliders lined up on our king with exactly one of our pieces in between
+    ctx.pinned = 0;
+    const Bitboard queens = pos.pieces(Them, PieceType::QUEEN);
+    Bitboard snipers = ((rookAttacks(ctx.kingSq, 0) & (pos.pieces(Them, PieceType::ROOK) | queens)) |
+                        (bishopAttacks(ctx.kingSq, 0) & (pos.pieces(Them, PieceType::BISHOP) | queens)));
+    while (snipers) {
+        const Bitboard blockers = BETWEEN_BB[ctx.kingSq][popLsb(snipers)] & ctx.occupied;
+        if (blockers && !moreThanOne(blockers) && (blockers & ctx.own)) {
+            ctx.pinned |= blockers;
+        }
+    }
+
+    if (!ctx.checkers) {
+        ctx.checkMask = ~0ULL;
+    } else if (!moreThanOne(ctx.checkers)) {
+        // Capture the checker or block the line it checks along
+        ctx.checkMask = BETWEEN_BB[ctx.kingSq][lsb(ctx.checkers)] | ctx.checkers;
+    } else {
+        ctx.checkMask = 0; // Double check: only the king can move
+    }
+
+    return ctx;
+}
+
+// Squares a piece on `from` may move to without exposing our king
+static Bitboard pinMask(const GenContext& ctx, int from) {
+    return (ctx.pinned & squareBB(from)) ? LINE_BB[ctx.kingSq][from] : ~0ULL;
+}
+
+// En passant is the one move that removes two pieces from a line at once,
+// so check it directly: lift both pawns, drop ours on the target square
+// and look for a slider that now sees the king
+template <PieceColor Us>
+static bool isLegalEnPassant(const Position& pos, const GenContext& ctx, int from, int to) {
+    constexpr PieceColor Them = opposite(Us);
+    const int capturedSq = (Us == PieceColor::WHITE) ? to - 8 : to + 8;
+
+    // When in check, the capture must remove the checker or block the check
+    if (ctx.checkers && !(ctx.checkMask & (squareBB(to) | squareBB(capturedSq)))) return false;
+
+    const Bitboard occupied = (ctx.occupied ^ squareBB(from) ^ squareBB(capturedSq)) | squareBB(to);
+    const Bitboard queens = pos.pieces(Them, PieceType::QUEEN);
+    return !(rookAttacks(ctx.kingSq, occupied) & (pos.pieces(Them, PieceType::ROOK) | queens)) &&
+           !(bishopAttacks(ctx.kingSq, occupied) & (pos.pieces(Them, PieceType::BISHOP) | queens));
+}
+
+template <PieceColor Us>
+static void generatePawnMoves(const Position& pos, const GenContext& ctx, MoveList& list) {
+    constexpr int forward = (Us == PieceColor::WHITE) ? 8 : -8;
+    constexpr Bitboard promotionRank = (Us == PieceColor::WHITE) ? RANK_8_BB : RANK_1_BB;
+    constexpr Bitboard doublePushRank = (Us == PieceColor::WHITE) ? RANK_4_BB : RANK_5_BB;
+    const Bitboard empty = ~ctx.occupied;
+    const int ep = pos.enPassantSquare();
+
+    Bitboard pawns = pos.pieces(Us, PieceType::PAWN);
+    while (pawns) {
+        const int from = popLsb(pawns);
+        const Bitboard allowed = pinMask(ctx, from) & ctx.checkMask;
+        const int to = from + forward;
+
+        // Pushes: promotions count as tactical, the rest as quiet
+        if (empty & squareBB(to)) {
+            if (promotionRank & squareBB(to)) {
+                if (ctx.tactical && (allowed & squareBB(to))) addPromotions(list, from, to, 0);
+            } else if (ctx.quiet) {
+                if (allowed & squareBB(to)) list.add(makeMove(from, to));
+                const int doubleTo = to + forward;
+                if ((doublePushRank & squareBB(doubleTo)) && (empty & allowed & squareBB(doubleTo))) {
+                    list.add(makeMove(from, doubleTo, DOUBLE_PUSH));
+                }
+            }
+        }
+
+        if (!ctx.tactical) continue;
+
+        // Captures
+        Bitboard captures = pawnAttacks<Us>(from) & ctx.enemies & allowed;
+        while (captures) {
+            const int target = popLsb(captures);
+            if (promotionRank & squareBB(target)) {
+                addPromotions(list, from, target, CAPTURE);
+            } else {
+                list.add(makeMove(from, target, CAPTURE));
+            }
+        }
+
+        // En passant
+        if (ep != NO_SQUARE && (pawnAttacks<Us>(from) & squareBB(ep)) &&
+            isLegalEnPassant<Us>(pos, ctx, from, ep)) {
+            list.add(makeMove(from, ep, EP_CAPTURE));
+        }
+    }
+}
+
+template <PieceColor Us>
+static void generateKingMoves(const Position& pos, const GenContext& ctx, MoveList& list) {
+    constexpr PieceColor Them = opposite(Us);
+    Bitboard stageTargets = 0;
+    if (ctx.tactical) stageTargets |= ctx.enemies;
+    if (ctx.quiet) stageTargets |= ~ctx.occupied;
+
+    // Look through the king so it cannot step back along a checking line
+    const Bitboard withoutKing = ctx.occupied ^ squareBB(ctx.kingSq);
+    Bitboard targets = kingAttacks(ctx.kingSq) & ~ctx.own & stageTargets;
+    while (targets) {
+        const int to = popLsb(targets);
+        if (!(pos.attackersTo(to, withoutKing) & ctx.enemies)) {
+            list.add(makeMove(ctx.kingSq, to, (ctx.enemies & squareBB(to)) ? CAPTURE : QUIET));
+        }
+    }
+
+    if (!ctx.quiet || ctx.checkers) return;
+
+    // Castling: the path must be empty and the king may not pass through or land on an attacked square
+    const int rights = pos.castlingRights();
+    constexpr int kingSide = (Us == PieceColor::WHITE) ? WHITE_OO : BLACK_OO;
+    constexpr int queenSide = (Us == PieceColor::WHITE) ? WHITE_OOO : BLACK_OOO;
+    const int k = ctx.kingSq;
+
+    if ((rights & kingSide) && !(ctx.occupied & (squareBB(k + 1) | squareBB(k + 2))) &&
+        !pos.isSquareAttacked(k + 1, Them) && !pos.isSquareAttacked(k + 2, Them)) {
+        list.add(makeMove(k, k + 2, KING_CASTLE));
+    }
+    if ((rights & queenSide) && !(ctx.occupied & (squareBB(k - 1) | squareBB(k - 2) | squareBB(k - 3))) &&
+        !pos.isSquareAttacked(k - 1, Them) && !pos.isSquareAttacked(k - 2, Them)) {
+        list.add(makeMove(k, k - 2, QUEEN_CASTLE));
+    }
+}
+
+template <PieceColor Us>
+static void generateAll(const Position& pos, MoveList& list, GenType type) {
+    const GenContext ctx = makeContext<Us>(pos, type);
+
+    generateKingMoves<Us>(pos, ctx, list);
+
+    // In double check nothing but the king may move
+    if (moreThanOne(ctx.checkers)) return;
+
+    generatePawnMoves<Us>(pos, ctx, list);
+
+    Bitboard stageTargets = 0;
+    if (ctx.tactical) stageTargets |= ctx.enemies;
+    if (ctx.quiet) stageTargets |= ~ctx.occupied;
+    const Bitboard targets = stageTargets & ctx.checkMask;
+
+    // Pinned knights can never move
+    Bitboard knights = pos.pieces(Us, PieceType::KNIGHT) & ~ctx.pinned;
+    while (knights) {
+        const int from = popLsb(knights);
+        addMoves(list, from, knightAttacks(from) & targets, ctx.enemies);
+    }
+
+    Bitboard bishops = pos.pieces(Us, PieceType::BISHOP);
+    while (bishops) {
+        const int from = popLsb(bishops);
+        addMoves(list, from, bishopAttacks(from, ctx.occupied) & targets & pinMask(ctx, from), ctx.enemies);
+    }
+
+    Bitboard rooks = pos.pieces(Us, PieceType::ROOK);
+    while (rooks) {
+        const int from = popLsb(rooks);
+        addMoves(list, from, rookAttacks(from, ctx.occupied) & targets & pinMask(ctx, from), ctx.enemies);
+    }
+
+    Bitboard queens = pos.pieces(Us, PieceType::QUEEN);
+    while (queens) {
+        const int from = popLsb(queens);
+        addMoves(list, from, queenAttacks(from, ctx.occupied) & targets & pinMask(ctx, from), ctx.enemies);
+    }
+}
+
+void generateMoves(const Position& pos, MoveList& list, GenType type) {
+    if (pos.sideToMove() == PieceColor::WHITE) {
+        generateAll<PieceColor::WHITE>(pos, list, type);
+    } else {
+        generateAll<PieceColor::BLACK>(pos, list, type);
+    }
+}
+
+void generateLegalMoves(const Position& pos, MoveList& list) {
+    list.count = 0;
+    generateMoves(pos, list, LEGAL);
+}
@@ -0,0 +1,45 @@
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "position.h"
+#include "move.h"
+
+// No legal chess position has more than 218 moves
+constexpr int MAX_MOVES = 256;
+
+/**
+ * @brief Fixed-capacity move container that lives on the stack
+ */
+struct MoveList {
+    Move moves[MAX_MOVES];
+    int count = 0;
+
+    void add(Move m) { moves[count++] = m; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    Move operator[](int i) const { return moves[i]; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+};
+
+// Which moves a generator stage produces
+enum GenType {
+    CAPTURES,   // Captures (including en passant) and all promotions
+    QUIETS,     // Everything else: non-capturing moves and castling
+    EVASIONS,   // Every legal move while in check
+    LEGAL       // Every legal move
+};
+
+/**
+ * @brief Appends the legal moves of one stage to the list
+ *
+ * Pins and checks are resolved with masks up front, so every move produced
+ * is legal without playing it. CAPTURES and QUIETS together make up LEGAL,
+ * in or out of check.
+ */
+void generateMoves(const Position& pos, MoveList& list, GenType type);
+
+// Generates every legal move for the side to move (clears the list first)
+void generateLegalMoves(const Position& pos, MoveList& list);
+
+#endif // MOVEGEN_H
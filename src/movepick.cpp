@@ -0,0 +1,260 @@
+#include <cstring>
+#include "movepick.h"
+#include "evaluate.h"
+#include "trace.h"
+
+void SearchHistory::clear() {
+    std::memset(butterfly, 0, sizeof(butterfly));
+    std::memset(counterMoves, 0, sizeof(counterMoves));
+    std::memset(continuation, 0, sizeof(continuation));
+}
+
+// One generation stage of the picker, timed in trace builds
+static void generateStage(const Position& pos, MoveList& list, GenType type) {
+    TRACE(if (activeTrace) activeTrace->movegenCalls++;
+          TraceTimer movegenTimer(activeTrace ? &activeTrace->movegenNs : nullptr));
+    generateMoves(pos, list, type);
+}
+
+bool seeGE(const Position& pos, Move move, int threshold) {
+    if (isCastling(move) || isEnPassant(move) || isPromotion(move)) return threshold <= 0;
+
+    const int from = moveFrom(move);
+    const int to = moveTo(move);
+
+    // What we win if the piece is not recaptured, then what we lose if it is
+    int swap = (isCapture(move) ? PIECE_VALUES[static_cast<int>(pos.typeOn(to))] : 0) - threshold;
+    if (swap < 0) return false;
+    swap = PIECE_VALUES[static_cast<int>(pos.typeOn(from))] - swap;
+    if (swap <= 0) return true;
+
+    Bitboard occupied = pos.pieces() ^ squareBB(from) ^ squareBB(to);
+    Bitboard attackers = pos.attackersTo(to, occupied);
+    const Bitboard diagonal = pos.pieces(PieceType::BISHOP) | pos.pieces(PieceType::QUEEN);
+    const Bitboard straight = pos.pieces(PieceType::ROOK) | pos.pieces(PieceType::QUEEN);
+    PieceColor stm = pos.sideToMove();
+    int result = 1;
+
+    // Alternate recaptures with the least valuable attacker until one side
+    // runs out or stops profiting; result flips with every capture made
+    for (;;) {
+        stm = opposite(stm);
+        attackers &= occupied;
+        const Bitboard stmAttackers = attackers & pos.pieces(stm);
+        if (!stmAttackers) break;
+        result ^= 1;
+
+        Bitboard bb;
+        if ((bb = stmAttackers & pos.pieces(PieceType::PAWN))) {
+            if ((swap = PIECE_VALUES[static_cast<int>(PieceType::PAWN)] - swap) < result) break;
+            occupied ^= squareBB(lsb(bb));
+            attackers |= bishopAttacks(to, occupied) & diagonal;
+        } else if ((bb = stmAttackers & pos.pieces(PieceType::KNIGHT))) {
+            if ((swap = PIECE_VALUES[static_cast<int>(PieceType::KNIGHT)] - swap) < result) break;
+            occupied ^= squareBB(lsb(bb));
+        } else if ((bb = stmAttackers & pos.pieces(PieceType::BISHOP))) {
+            if ((swap = PIECE_VALUES[static_cast<int>(PieceType::BISHOP)] - swap) < result) break;
+            occupied ^= squareBB(lsb(bb));
+            attackers |= bishopAttacks(to, occupied) & diagonal;
+        } else if ((bb = stmAttackers & pos.pieces(PieceType::ROOK))) {
+            if ((swap = PIECE_VALUES[static_cast<int>(PieceType::ROOK)] - swap) < result) break;
+            occupied ^= squareBB(lsb(bb));
+            attackers |= rookAttacks(to, occupied) & straight;
+        } else if ((bb = stmAttackers & pos.pieces(PieceType::QUEEN))) {
+            if ((swap = PIECE_VALUES[static_cast<int>(PieceType::QUEEN)] - swap) < result) break;
+            occupied ^= squareBB(lsb(bb));
+            attackers |= (bishopAttacks(to, occupied) & diagonal) | (rookAttacks(to, occupied) & straight);
+        } else {
+            // Only the king is left: it may recapture only if the square is not defended
+            return (attackers & ~pos.pieces(stm)) ? result ^ 1 : result;
+        }
+    }
+
+    return result != 0;
+}
+
+static bool isTactical(Move move) {
+    return isCapture(move) || isPromotion(move);
+}
+
+MovePicker::MovePicker(const Position& position, PickerStorage& storage, Move tt,
+                       const SearchHistory& searchHistory, const Move* killers, int prevPiece, int prevTo,
+                       const PieceToHistory* continuation1, const PieceToHistory* continuation2,
+                       bool quietsWanted)
+    : pos(position), history(searchHistory), cont1(continuation1), cont2(continuation2),
+      ttMove(tt), killer1(NO_MOVE), killer2(NO_MOVE), counterMove(NO_MOVE), includeQuiets(quietsWanted),
+      captures(storage.captures), quiets(storage.quiets), captureScores(storage.captureScores),
+      quietScores(storage.quietScores), badCaptures(storage.badCaptures) {
+    // The storage still holds the lists of the last picker that used it
+    captures.count = 0;
+    quiets.count = 0;
+
+    if (pos.inCheck()) {
+        stage = INIT_EVASIONS;
+        return;
+    }
+
+    stage = TT_MOVE;
+    if (!includeQuiets && ttMove != NO_MOVE && !isTactical(ttMove)) ttMove = NO_MOVE;
+    if (includeQuiets) {
+        if (killers) {
+            killer1 = killers[0];
+            killer2 = killers[1];
+        }
+        if (prevPiece >= 0) counterMove = history.counterMoves[prevPiece][prevTo];
+    }
+}
+
+void MovePicker::generateQuietsOnce() {
+    if (quietsGenerated) return;
+    generateStage(pos, quiets, QUIETS);
+    quietsGenerated = true;
+}
+
+bool MovePicker::isGeneratedQuiet(Move move) {
+    if (move == NO_MOVE || isTactical(move)) return false;
+    generateQuietsOnce();
+    for (Move quiet : quiets) {
+        if (quiet == move) return true;
+    }
+    return false;
+}
+
+// MVV-LVA: the most valuable victim first, the cheapest attacker breaking ties
+int MovePicker::captureScore(Move move) const {
+    int score = 0;
+    if (isCapture(move)) {
+        const PieceType victim = isEnPassant(move) ? PieceType::PAWN : pos.typeOn(moveTo(move));
+        score = 10 * PIECE_VALUES[static_cast<int>(victim)] -
+                PIECE_VALUES[static_cast<int>(pos.typeOn(moveFrom(move)))] / 10;
+    }
+    if (isPromotion(move)) score += PIECE_VALUES[static_cast<int>(promotionType(move))];
+    return score;
+}
+
+int MovePicker::quietScore(Move move) const {
+    const int from = moveFrom(move);
+    const int to = moveTo(move);
+    const int piece = pieceIndex(pos.sideToMove(), pos.typeOn(from));
+
+    int score = history.butterfly[static_cast<int>(pos.sideToMove())][from][to];
+    if (cont1) score += (*cont1)[piece][to];
+    if (cont2) score += (*cont2)[piece][to];
+    return score;
+}
+
+// Selection sort step: swap the best remaining move to the front and return it
+Move MovePicker::pickBest(MoveList& list, int* scores, int& index) {
+    if (index >= list.count) return NO_MOVE;
+
+    int best = index;
+    for (int i = index + 1; i < list.count; ++i) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    if (best != index) {
+        const Move move = list.moves[best];
+        list.moves[best] = list.moves[index];
+        list.moves[index] = move;
+        const int score = scores[best];
+        scores[best] = scores[index];
+        scores[index] = score;
+    }
+    return list.moves[index++];
+}
+
+Move MovePicker::next() {
+    Move move;
+
+    switch (stage) {
+    case TT_MOVE:
+        stage = INIT_CAPTURES;
+        if (ttMove != NO_MOVE) {
+            // The TT move may come from a colliding position, so check it is one of ours
+            bool legal = false;
+            if (isTactical(ttMove)) {
+                generateStage(pos, captures, CAPTURES);
+                for (Move capture : captures) legal = legal || capture == ttMove;
+            } else {
+                legal = isGeneratedQuiet(ttMove);
+            }
+            if (legal) return ttMove;
+            ttMove = NO_MOVE;
+        }
+        [[fallthrough]];
+
+    case INIT_CAPTURES:
+        if (captures.empty()) generateStage(pos, captures, CAPTURES);
+        for (int i = 0; i < captures.count; ++i) captureScores[i] = captureScore(captures.moves[i]);
+        stage = GOOD_CAPTURES;
+        [[fallthrough]];
+
+    case GOOD_CAPTURES:
+        while ((move = pickBest(captures, captureScores, captureIndex)) != NO_MOVE) {
+            if (move == ttMove) continue;
+            if (seeGE(pos, move, 0)) return move;
+            badCaptures[badCount++] = move;
+        }
+        if (!includeQuiets) {
+            stage = DONE;
+            return NO_MOVE;
+        }
+        stage = KILLER_1;
+        [[fallthrough]];
+
+    case KILLER_1:
+        stage = KILLER_2;
+        if (killer1 != ttMove && isGeneratedQuiet(killer1)) return killer1;
+        [[fallthrough]];
+
+    case KILLER_2:
+        stage = COUNTER_MOVE;
+        if (killer2 != ttMove && killer2 != killer1 && isGeneratedQuiet(killer2)) return killer2;
+        [[fallthrough]];
+
+    case COUNTER_MOVE:
+        stage = INIT_QUIETS;
+        if (counterMove != ttMove && counterMove != killer1 && counterMove != killer2 &&
+            isGeneratedQuiet(counterMove)) {
+            return counterMove;
+        }
+        [[fallthrough]];
+
+    case INIT_QUIETS:
+        generateQuietsOnce();
+        for (int i = 0; i < quiets.count; ++i) quietScores[i] = quietScore(quiets.moves[i]);
+        stage = QUIET_MOVES;
+        [[fallthrough]];
+
+    case QUIET_MOVES:
+        while (!quietsSkipped && (move = pickBest(quiets, quietScores, quietIndex)) != NO_MOVE) {
+            if (!isSpecial(move)) return move;
+        }
+        stage = BAD_CAPTURES;
+        [[fallthrough]];
+
+    case BAD_CAPTURES:
+        if (badIndex < badCount) return badCaptures[badIndex++];
+        stage = DONE;
+        return NO_MOVE;
+
+    case INIT_EVASIONS:
+        // Few moves get out of check, so score them all at once: TT move,
+        // then captures, then quiet moves by history
+        generateStage(pos, captures, EVASIONS);
+        for (int i = 0; i < captures.count; ++i) {
+            const Move evasion = captures.moves[i];
+            captureScores[i] = evasion == ttMove ? (1 << 30)
+                             : isTactical(evasion) ? (1 << 20) + captureScore(evasion)
+                             : quietScore(evasion);
+        }
+        stage = EVASION_MOVES;
+        [[fallthrough]];
+
+    case EVASION_MOVES:
+        return pickBest(captures, captureScores, captureIndex);
+
+    case DONE:
+        break;
+    }
+    return NO_MOVE;
+}
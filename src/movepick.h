@@ -0,0 +1,126 @@
+#ifndef MOVEPICK_H
+#define MOVEPICK_H
+
+#include <cstdint>
+#include "position.h"
+#include "movegen.h"
+
+// History scores saturate towards +-MAX_HISTORY
+constexpr int MAX_HISTORY = 16384;
+
+// A piece as one index: color * 6 + type
+constexpr int PIECE_INDEX_COUNT = COLOR_COUNT * PIECE_TYPE_COUNT;
+inline int pieceIndex(PieceColor color, PieceType type) {
+    return static_cast<int>(color) * PIECE_TYPE_COUNT + static_cast<int>(type);
+}
+
+// History of quiet moves keyed by the piece that moved and its destination
+using PieceToHistory = std::int16_t[PIECE_INDEX_COUNT][64];
+
+/**
+ * @brief Move ordering statistics gathered by one search thread
+ *
+ * The butterfly table scores quiet moves by side, origin and destination;
+ * the counter-move table remembers the reply that refuted a given previous
+ * move; and the continuation tables score a move by the move played one or
+ * two plies before it. Killers are kept per ply by the search itself.
+ */
+struct SearchHistory {
+    std::int16_t butterfly[COLOR_COUNT][64][64];
+    Move counterMoves[PIECE_INDEX_COUNT][64];
+    PieceToHistory continuation[PIECE_INDEX_COUNT][64];
+
+    void clear();
+};
+
+// Nudges a history entry towards +-MAX_HISTORY, the nudge shrinking as it gets there
+inline void updateHistoryEntry(std::int16_t& entry, int bonus) {
+    const int clamped = bonus < -MAX_HISTORY ? -MAX_HISTORY : (bonus > MAX_HISTORY ? MAX_HISTORY : bonus);
+    entry = static_cast<std::int16_t>(entry + clamped - entry * (clamped < 0 ? -clamped : clamped) / MAX_HISTORY);
+}
+
+/**
+ * @brief Static exchange evaluation: does the move win at least threshold?
+ *
+ * Plays out the capture sequence on the destination square, least valuable
+ * attacker first, including attackers uncovered behind sliders. Castling,
+ * en passant and promotions are scored as an even exchange.
+ */
+bool seeGE(const Position& pos, Move move, int threshold);
+
+// Move lists and scores of one MovePicker, owned by the caller so that the
+// search can keep one set per ply instead of on every node's stack frame
+struct PickerStorage {
+    MoveList captures;
+    MoveList quiets;
+    int captureScores[MAX_MOVES];
+    int quietScores[MAX_MOVES];
+    Move badCaptures[MAX_MOVES];        // Losing captures, tried last in the order they were found
+};
+
+/**
+ * @brief Hands out the legal moves of a position one at a time, best guess first
+ *
+ * Moves come in stages so a cutoff early in the list skips the later work:
+ * the TT move; captures and promotions that do not lose material (by SEE),
+ * best MVV-LVA first; the two killers and the counter-move; quiet moves by
+ * history; and finally the losing captures. When in check all evasions are
+ * generated and scored together. Each stage is selection-sorted lazily, one
+ * pick at a time. With quiets disabled (for quiescence search) only the TT
+ * move and captures are returned.
+ */
+class MovePicker {
+public:
+    // storage must not be used by another picker while this one is; killers
+    // points to the two killers of this ply (or is null); prevPiece/prevTo
+    // describe the previous move (-1 at the root or after a null move);
+    // cont1/cont2 are the continuation tables of the moves one and two plies back, or null
+    MovePicker(const Position& pos, PickerStorage& storage, Move ttMove, const SearchHistory& history,
+               const Move* killers, int prevPiece, int prevTo, const PieceToHistory* cont1,
+               const PieceToHistory* cont2, bool includeQuiets = true);
+
+    // The next move to search, or NO_MOVE when all have been returned
+    Move next();
+
+    // Lets the caller skip the remaining quiet moves (e.g. late-move pruning)
+    void skipQuiets() { quietsSkipped = true; }
+
+private:
+    enum Stage {
+        TT_MOVE, INIT_CAPTURES, GOOD_CAPTURES, KILLER_1, KILLER_2, COUNTER_MOVE,
+        INIT_QUIETS, QUIET_MOVES, BAD_CAPTURES, INIT_EVASIONS, EVASION_MOVES, DONE
+    };
+
+    const Position& pos;
+    const SearchHistory& history;
+    const PieceToHistory* cont1;
+    const PieceToHistory* cont2;
+    Move ttMove;
+    Move killer1;
+    Move killer2;
+    Move counterMove;
+    bool includeQuiets;
+    bool quietsSkipped = false;
+    bool quietsGenerated = false;
+    int stage;
+
+    MoveList& captures;
+    MoveList& quiets;
+    int* const captureScores;
+    int* const quietScores;
+    int captureIndex = 0;
+    int quietIndex = 0;
+
+    Move* const badCaptures;
+    int badCount = 0;
+    int badIndex = 0;
+
+    void generateQuietsOnce();
+    bool isGeneratedQuiet(Move move);
+    int captureScore(Move move) const;
+    int quietScore(Move move) const;
+    Move pickBest(MoveList& list, int* scores, int& index);
+    bool isSpecial(Move move) const { return move == ttMove || move == killer1 || move == killer2 || move == counterMove; }
+};
+
+#endif // MOVEPICK_H
@@ -0,0 +1,299 @@
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <new>
+#include "nnue.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define NNUE_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NNUE_NEON 1
+#endif
+
+// Keeps the network's output well inside the range of non-mate scores
+constexpr int NNUE_MAX_EVAL = 20000;
+
+// A move changes at most two features per perspective each way (castling, captures)
+constexpr int MAX_FEATURE_DELTAS = 2;
+
+struct Network {
+    alignas(64) std::int16_t featureWeights[NNUE_INPUTS * NNUE_HIDDEN];
+    alignas(64) std::int16_t featureBiases[NNUE_HIDDEN];
+    alignas(64) std::int16_t outputWeights[2 * NNUE_HIDDEN];
+    std::int16_t outputBias;
+};
+
+static std::unique_ptr<Network> network;
+
+// ---------------------------------------------------------------------------
+// Kernels: out = in + sum(adds) - sum(subs) over the hidden layer, and the
+// clipped-ReLU dot product of one accumulator half with the output weights.
+// Rows and accumulators are 64-byte aligned and NNUE_HIDDEN is a multiple of
+// 32, so every variant works on whole aligned vectors.
+// ---------------------------------------------------------------------------
+
+using DeltaKernel = void (*)(std::int16_t* out, const std::int16_t* in,
+                             const std::int16_t* const* adds, int addCount,
+                             const std::int16_t* const* subs, int subCount);
+using DotKernel = std::int32_t (*)(const std::int16_t* acc, const std::int16_t* weights);
+
+static void applyDeltasScalar(std::int16_t* out, const std::int16_t* in,
+                              const std::int16_t* const* adds, int addCount,
+                              const std::int16_t* const* subs, int subCount) {
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        int value = in[i];
+        for (int a = 0; a < addCount; ++a) value += adds[a][i];
+        for (int s = 0; s < subCount; ++s) value -= subs[s][i];
+        out[i] = static_cast<std::int16_t>(value);
+    }
+}
+
+static std::int32_t dotScalar(const std::int16_t* acc, const std::int16_t* weights) {
+    std::int32_t sum = 0;
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        const int clipped = acc[i] < 0 ? 0 : (acc[i] > NNUE_QA ? NNUE_QA : acc[i]);
+        sum += clipped * weights[i];
+    }
+    return sum;
+}
+
+#ifdef NNUE_X86
+__attribute__((target("avx2")))
+static void applyDeltasAVX2(std::int16_t* out, const std::int16_t* in,
+                            const std::int16_t* const* adds, int addCount,
+                            const std::int16_t* const* subs, int subCount) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i value = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + i));
+        for (int a = 0; a < addCount; ++a) {
+            value = _mm256_add_epi16(value, _mm256_load_si256(reinterpret_cast<const __m256i*>(adds[a] + i)));
+        }
+        for (int s = 0; s < subCount; ++s) {
+            value = _mm256_sub_epi16(value, _mm256_load_si256(reinterpret_cast<const __m256i*>(subs[s] + i)));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out + i), value);
+    }
+}
+
+__attribute__((target("avx2")))
+static std::int32_t dotAVX2(const std::int16_t* acc, const std::int16_t* weights) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ceiling = _mm256_set1_epi16(NNUE_QA);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i value = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        value = _mm256_min_epi16(_mm256_max_epi16(value, zero), ceiling);
+        const __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(value, w));
+    }
+    __m128i total = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0x4E));
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0xB1));
+    return _mm_cvtsi128_si32(total);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void applyDeltasAVX512(std::int16_t* out, const std::int16_t* in,
+                              const std::int16_t* const* adds, int addCount,
+                              const std::int16_t* const* subs, int subCount) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m512i value = _mm512_load_si512(in + i);
+        for (int a = 0; a < addCount; ++a) value = _mm512_add_epi16(value, _mm512_load_si512(adds[a] + i));
+        for (int s = 0; s < subCount; ++s) value = _mm512_sub_epi16(value, _mm512_load_si512(subs[s] + i));
+        _mm512_store_si512(out + i, value);
+    }
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static std::int32_t dotAVX512(const std::int16_t* acc, const std::int16_t* weights) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i ceiling = _mm512_set1_epi16(NNUE_QA);
+    __m512i sum = _mm512_setzero_si512();
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m512i value = _mm512_min_epi16(_mm512_max_epi16(_mm512_load_si512(acc + i), zero), ceiling);
+        sum = _mm512_add_epi32(sum, _mm512_madd_epi16(value, _mm512_load_si512(weights + i)));
+    }
+    // Summed through memory: GCC's _mm512_reduce_add_epi32 trips -Wuninitialized
+    alignas(64) std::int32_t lanes[16];
+    _mm512_store_si512(lanes, sum);
+    std::int32_t total = 0;
+    for (std::int32_t lane : lanes) total += lane;
+    return total;
+}
+#endif // NNUE_X86
+
+#ifdef NNUE_NEON
+static void applyDeltasNEON(std::int16_t* out, const std::int16_t* in,
+                            const std::int16_t* const* adds, int addCount,
+                            const std::int16_t* const* subs, int subCount) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        int16x8_t value = vld1q_s16(in + i);
+        for (int a = 0; a < addCount; ++a) value = vaddq_s16(value, vld1q_s16(adds[a] + i));
+        for (int s = 0; s < subCount; ++s) value = vsubq_s16(value, vld1q_s16(subs[s] + i));
+        vst1q_s16(out + i, value);
+    }
+}
+
+static std::int32_t dotNEON(const std::int16_t* acc, const std::int16_t* weights) {
+    const int16x8_t zero = vdupq_n_s16(0);
+    const int16x8_t ceiling = vdupq_n_s16(NNUE_QA);
+    int32x4_t sum = vdupq_n_s32(0);
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        const int16x8_t value = vminq_s16(vmaxq_s16(vld1q_s16(acc + i), zero), ceiling);
+        const int16x8_t w = vld1q_s16(weights + i);
+        sum = vmlal_s16(sum, vget_low_s16(value), vget_low_s16(w));
+        sum = vmlal_s16(sum, vget_high_s16(value), vget_high_s16(w));
+    }
+    return vgetq_lane_s32(sum, 0) + vgetq_lane_s32(sum, 1) + vgetq_lane_s32(sum, 2) + vgetq_lane_s32(sum, 3);
+}
+#endif // NNUE_NEON
+
+struct NNUEKernels {
+    const char* name;
+    DeltaKernel applyDeltas;
+    DotKernel dot;
+};
+
+// Picks the widest instruction set the CPU running us supports, whatever the build targeted
+static NNUEKernels pickKernels() {
+#if defined(NNUE_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) return {"avx512", applyDeltasAVX512, dotAVX512};
+    if (__builtin_cpu_supports("avx2")) return {"avx2", applyDeltasAVX2, dotAVX2};
+#elif defined(NNUE_NEON)
+    return {"neon", applyDeltasNEON, dotNEON};
+#endif
+    return {"scalar", applyDeltasScalar, dotScalar};
+}
+
+static const NNUEKernels kernels = pickKernels();
+
+// ---------------------------------------------------------------------------
+
+static int featureIndex(PieceColor perspective, int sq, PieceType type, PieceColor color) {
+    const int side = (color == perspective) ? 0 : 1;
+    const int relativeSq = (perspective == PieceColor::WHITE) ? sq : (sq ^ 56);
+    return (side * PIECE_TYPE_COUNT + static_cast<int>(type)) * 64 + relativeSq;
+}
+
+static const std::int16_t* featureRow(PieceColor perspective, int sq, PieceType type, PieceColor color) {
+    return network->featureWeights + featureIndex(perspective, sq, type, color) * NNUE_HIDDEN;
+}
+
+bool loadNetwork(const std::string& path) {
+    network.reset();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Warning: Could not open network file " << path << std::endl;
+        return false;
+    }
+
+    // Header: magic, version, hidden layer size
+    char magic[4] = {};
+    std::uint32_t version = 0;
+    std::uint32_t hidden = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&hidden), sizeof(hidden));
+    if (!file || std::string(magic, 4) != "PHNN" || version != 1 || hidden != NNUE_HIDDEN) {
+        std::cerr << "Warning: " << path << " is not a " << NNUE_HIDDEN << "-neuron network file" << std::endl;
+        return false;
+    }
+
+    // Every target we build for is little-endian, so the arrays are read as they are
+    std::unique_ptr<Network> loaded(new (std::nothrow) Network);
+    if (!loaded) {
+        std::cerr << "Warning: Out of memory loading " << path << std::endl;
+        return false;
+    }
+    file.read(reinterpret_cast<char*>(loaded->featureWeights), sizeof(loaded->featureWeights));
+    file.read(reinterpret_cast<char*>(loaded->featureBiases), sizeof(loaded->featureBiases));
+    file.read(reinterpret_cast<char*>(loaded->outputWeights), sizeof(loaded->outputWeights));
+    file.read(reinterpret_cast<char*>(&loaded->outputBias), sizeof(loaded->outputBias));
+    if (!file || file.peek() != std::ifstream::traits_type::eof()) {
+        std::cerr << "Warning: " << path << " has the wrong size for a " << NNUE_HIDDEN
+                  << "-neuron network" << std::endl;
+        return false;
+    }
+
+    network = std::move(loaded);
+    return true;
+}
+
+void unloadNetwork() {
+    network.reset();
+}
+
+bool isNetworkLoaded() {
+    return network != nullptr;
+}
+
+const char* nnueKernelName() {
+    return kernels.name;
+}
+
+void refreshAccumulator(const Position& pos, Accumulator& acc) {
+    for (int p = 0; p < COLOR_COUNT; ++p) {
+        const PieceColor perspective = static_cast<PieceColor>(p);
+        std::int16_t* values = acc.values[p];
+        for (int i = 0; i < NNUE_HIDDEN; ++i) values[i] = network->featureBiases[i];
+
+        Bitboard occupied = pos.pieces();
+        while (occupied) {
+            const int sq = popLsb(occupied);
+            PieceType type;
+            PieceColor color;
+            pos.pieceAt(sq, type, color);
+            const std::int16_t* row = featureRow(perspective, sq, type, color);
+            kernels.applyDeltas(values, values, &row, 1, nullptr, 0);
+        }
+    }
+}
+
+void updateAccumulator(const Accumulator& parent, Accumulator& child,
+                       const Position& pos, Move move, const UndoInfo& undo) {
+    const int from = moveFrom(move);
+    const int to = moveTo(move);
+    const int flags = moveFlags(move);
+    const PieceColor them = pos.sideToMove();
+    const PieceColor us = opposite(them);
+    const PieceType placed = pos.typeOn(to);
+    const PieceType moved = (flags & PROMOTION) ? PieceType::PAWN : placed;
+
+    for (int p = 0; p < COLOR_COUNT; ++p) {
+        const PieceColor perspective = static_cast<PieceColor>(p);
+        const std::int16_t* adds[MAX_FEATURE_DELTAS];
+        const std::int16_t* subs[MAX_FEATURE_DELTAS];
+        int addCount = 0;
+        int subCount = 0;
+
+        adds[addCount++] = featureRow(perspective, to, placed, us);
+        subs[subCount++] = featureRow(perspective, from, moved, us);
+
+        if (undo.captured != NO_CAPTURE) {
+            const int capturedSq = (flags == EP_CAPTURE) ? (us == PieceColor::WHITE ? to - 8 : to + 8) : to;
+            subs[subCount++] = featureRow(perspective, capturedSq, static_cast<PieceType>(undo.captured), them);
+        } else if (flags == KING_CASTLE) {
+            adds[addCount++] = featureRow(perspective, to - 1, PieceType::ROOK, us);
+            subs[subCount++] = featureRow(perspective, to + 1, PieceType::ROOK, us);
+        } else if (flags == QUEEN_CASTLE) {
+            adds[addCount++] = featureRow(perspective, to + 1, PieceType::ROOK, us);
+            subs[subCount++] = featureRow(perspective, to - 2, PieceType::ROOK, us);
+        }
+
+        kernels.applyDeltas(child.values[p], parent.values[p], adds, addCount, subs, subCount);
+    }
+}
+
+int evaluateNNUE(const Position& pos, const Accumulator& acc) {
+    const int us = static_cast<int>(pos.sideToMove());
+    const int them = us ^ 1;
+
+    const std::int64_t output = static_cast<std::int64_t>(kernels.dot(acc.values[us], network->outputWeights)) +
+                                kernels.dot(acc.values[them], network->outputWeights + NNUE_HIDDEN) +
+                                network->outputBias;
+    const std::int64_t score = output * NNUE_SCALE / (NNUE_QA * NNUE_QB);
+    return static_cast<int>(score < -NNUE_MAX_EVAL ? -NNUE_MAX_EVAL : (score > NNUE_MAX_EVAL ? NNUE_MAX_EVAL : score));
+}
@@ -0,0 +1,65 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstdint>
+#include <string>
+#include "position.h"
+
+// Network shape: 768 piece-square inputs per side -> NNUE_HIDDEN -> 1,
+// with the side to move's half of the hidden layer first
+constexpr int NNUE_INPUTS = 2 * PIECE_TYPE_COUNT * 64;
+constexpr int NNUE_HIDDEN = 256;
+
+// Quantization: hidden activations clip to [0, NNUE_QA], output weights are
+// scaled by NNUE_QB, and the network output times NNUE_SCALE is centipawns
+constexpr int NNUE_QA = 255;
+constexpr int NNUE_QB = 64;
+constexpr int NNUE_SCALE = 400;
+
+// Looked for in the working directory at startup
+constexpr const char* DEFAULT_EVAL_FILE = "phosphor.nnue";
+
+/**
+ * @brief Hidden layer values for both perspectives of one position
+ *
+ * Search keeps one per ply and derives each child's from its parent's by
+ * adding and subtracting the weight rows of the few features a move changes.
+ */
+struct alignas(64) Accumulator {
+    std::int16_t values[COLOR_COUNT][NNUE_HIDDEN]; // [perspective][neuron]
+};
+
+/**
+ * @brief Loads a quantized network, replacing the current one
+ *
+ * The file is the 12-byte header "PHNN", version 1 and NNUE_HIDDEN as
+ * little-endian uint32s, followed by little-endian int16 arrays: feature
+ * weights [NNUE_INPUTS][NNUE_HIDDEN], feature biases [NNUE_HIDDEN], output
+ * weights [2 * NNUE_HIDDEN] and the output bias. Input features are indexed
+ * (side * 6 + piece type) * 64 + square, relative to the perspective: side 0
+ * is the perspective's own pieces and Black's squares are flipped vertically.
+ * Must not be called while a search is running.
+ * @return False if the file is missing or malformed, leaving no network loaded
+ */
+bool loadNetwork(const std::string& path);
+void unloadNetwork();
+bool isNetworkLoaded();
+
+// Name of the SIMD kernel picked for this CPU ("avx512", "avx2", "neon" or "scalar")
+const char* nnueKernelName();
+
+// Computes an accumulator from scratch
+void refreshAccumulator(const Position& pos, Accumulator& acc);
+
+// Derives the accumulator after a move from the one before it; pos is the position after the move
+void updateAccumulator(const Accumulator& parent, Accumulator& child,
+                       const Position& pos, Move move, const UndoInfo& undo);
+
+/**
+ * @brief Network evaluation in centipawns from the side to move's point of view
+ *
+ * acc must be up to date for pos and a network must be loaded.
+ */
+int evaluateNNUE(const Position& pos, const Accumulator& acc);
+
+#endif // NNUE_H
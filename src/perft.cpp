@@ -0,0 +1,391 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include "perft.h"
+#include "movegen.h"
+#include "game_logic.h"
+
+// Reference values for standard position - first 8 plies
+const long long EXPECTED_NODES[] = {
+    20,            // Depth 1
+    400,           // Depth 2
+    8902,          // Depth 3
+    197281,        // Depth 4
+    4865609,       // Depth 5
+    119060324,     // Depth 6
+    3195901860,    // Depth 7
+    84998978956    // Depth 8
+};
+
+long long expectedStartPositionNodes(int depth) {
+    const int expectedCount = sizeof(EXPECTED_NODES) / sizeof(EXPECTED_NODES[0]);
+    return (depth >= 1 && depth <= expectedCount) ? EXPECTED_NODES[depth - 1] : -1;
+}
+
+// Count leaf nodes of the legal move tree, playing moves in place
+long long perft(Position& pos, int depth) {
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+
+    // Bulk counting: the number of legal moves is the leaf count at depth 1
+    if (depth <= 1) {
+        return depth == 1 ? moves.size() : 1;
+    }
+
+    long long nodes = 0;
+    UndoInfo undo;
+    for (Move move : moves) {
+        pos.makeMove(move, undo);
+        nodes += perft(pos, depth - 1);
+        pos.unmakeMove(move, undo);
+    }
+    return nodes;
+}
+
+/**
+ * @brief Subtree counts keyed by (position, depth), shared by all perft threads
+ *
+ * Same lockless scheme as the search's transposition table: the key is
+ * stored XORed with the count, so a torn write fails verification and is
+ * treated as a miss. Entries are always replaced.
+ */
+class PerftHashTable {
+public:
+    explicit PerftHashTable(std::size_t megabytes) {
+        count = megabytes * 1024 * 1024 / sizeof(Entry);
+        entries.reset(count ? new (std::nothrow) Entry[count] : nullptr);
+        if (!entries) {
+            count = 0;
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            entries[i].keyXorNodes.store(0, std::memory_order_relaxed);
+            entries[i].nodes.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool enabled() const { return count != 0; }
+
+    bool probe(Key key, int depth, long long& nodes) const {
+        const Key k = mix(key, depth);
+        const Entry& entry = entryFor(k);
+        const std::uint64_t stored = entry.nodes.load(std::memory_order_relaxed);
+        if (stored != 0 && (entry.keyXorNodes.load(std::memory_order_relaxed) ^ stored) == k) {
+            nodes = static_cast<long long>(stored);
+            return true;
+        }
+        return false;
+    }
+
+    void store(Key key, int depth, long long nodes) {
+        const Key k = mix(key, depth);
+        Entry& entry = entryFor(k);
+        entry.keyXorNodes.store(k ^ static_cast<std::uint64_t>(nodes), std::memory_order_relaxed);
+        entry.nodes.store(static_cast<std::uint64_t>(nodes), std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry {
+        std::atomic<std::uint64_t> keyXorNodes;
+        std::atomic<std::uint64_t> nodes;
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    std::size_t count = 0;
+
+    // The same position at different depths must land on different entries
+    static Key mix(Key key, int depth) {
+        return key ^ (static_cast<Key>(depth) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    const Entry& entryFor(Key k) const {
+        return entries[static_cast<std::size_t>((static_cast<__uint128_t>(k) * count) >> 64)];
+    }
+    Entry& entryFor(Key k) {
+        return entries[static_cast<std::size_t>((static_cast<__uint128_t>(k) * count) >> 64)];
+    }
+};
+
+static long long perftHashed(Position& pos, int depth, PerftHashTable& table) {
+    long long nodes = 0;
+    if (depth >= 2 && table.probe(pos.hashKey(), depth, nodes)) {
+        return nodes;
+    }
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    if (depth <= 1) {
+        return depth == 1 ? moves.size() : 1;
+    }
+
+    UndoInfo undo;
+    for (Move move : moves) {
+        pos.makeMove(move, undo);
+        nodes += perftHashed(pos, depth - 1, table);
+        pos.unmakeMove(move, undo);
+    }
+
+    table.store(pos.hashKey(), depth, nodes);
+    return nodes;
+}
+
+// A subtree to count and the root move it belongs to
+struct PerftTask {
+    Position pos;
+    int depth;
+    int rootIndex;
+};
+
+// One worker's tasks: the owner pops from the back, thieves take from the front
+class PerftTaskQueue {
+public:
+    void push(const PerftTask& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+
+    bool pop(PerftTask& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return false;
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    bool steal(PerftTask& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return false;
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<PerftTask> tasks;
+};
+
+// Expand the tree `plies` deep, turning every node reached into a task
+static void collectTasks(Position& pos, int plies, int remaining, int rootIndex,
+                         std::vector<PerftTask>& tasks) {
+    if (plies == 0) {
+        tasks.push_back({pos, remaining, rootIndex});
+        return;
+    }
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    UndoInfo undo;
+    for (Move move : moves) {
+        pos.makeMove(move, undo);
+        collectTasks(pos, plies - 1, remaining, rootIndex, tasks);
+        pos.unmakeMove(move, undo);
+    }
+}
+
+// One run's tasks and counts, shared by the threads of a PerftRunner
+struct PerftJob {
+    std::vector<PerftTaskQueue> queues;                 // One per thread
+    std::vector<std::atomic<long long>> rootCounts;
+    PerftHashTable& table;
+
+    PerftJob(int threadCount, int rootMoves, PerftHashTable& table)
+        : queues(threadCount), rootCounts(rootMoves), table(table) {}
+};
+
+static void workOnJob(PerftJob& job, int self) {
+    const int threadCount = static_cast<int>(job.queues.size());
+    PerftTask task;
+    for (;;) {
+        bool found = job.queues[self].pop(task);
+        for (int k = 1; !found && k < threadCount; ++k) {
+            found = job.queues[(self + k) % threadCount].steal(task);
+        }
+        if (!found) return; // No task is ever added once workers start
+
+        const long long nodes = job.table.enabled() ? perftHashed(task.pos, task.depth, job.table)
+                                                    : perft(task.pos, task.depth);
+        job.rootCounts[task.rootIndex].fetch_add(nodes, std::memory_order_relaxed);
+    }
+}
+
+PerftRunner::PerftRunner(const PerftOptions& options)
+    : splitDepth(options.splitDepth < 1 ? 1 : options.splitDepth),
+      table(std::make_unique<PerftHashTable>(options.hashMB)) {
+    int threadCount = options.threads > 0 ? options.threads
+                                          : static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount < 1) threadCount = 1;
+    for (int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(&PerftRunner::helperLoop, this, i);
+    }
+}
+
+PerftRunner::~PerftRunner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// Sleeps between jobs; works on each new one alongside the thread that posted it
+void PerftRunner::helperLoop(int self) {
+    int seen = 0;
+    for (;;) {
+        PerftJob* current;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+            current = job;
+        }
+        workOnJob(*current, self);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0) finished.notify_one();
+    }
+}
+
+PerftResult PerftRunner::run(const Position& root, int depth) {
+    const auto startTime = std::chrono::steady_clock::now();
+    PerftResult result;
+
+    Position pos = root;
+    MoveList rootMoves;
+    generateLegalMoves(pos, rootMoves);
+    for (Move move : rootMoves) {
+        result.divide.push_back({move, depth <= 1 ? 1 : 0});
+    }
+
+    if (depth <= 1) {
+        result.nodes = depth == 1 ? rootMoves.size() : 1;
+        result.divide.resize(depth == 1 ? rootMoves.size() : 0);
+    } else {
+        const int threadCount = static_cast<int>(threads.size()) + 1;
+
+        // Split below the root move, but always leave at least one ply for the workers
+        const int split = splitDepth > depth - 1 ? depth - 1 : splitDepth;
+
+        std::vector<PerftTask> tasks;
+        UndoInfo undo;
+        for (int i = 0; i < rootMoves.size(); ++i) {
+            pos.makeMove(rootMoves[i], undo);
+            collectTasks(pos, split - 1, depth - split, i, tasks);
+            pos.unmakeMove(rootMoves[i], undo);
+        }
+
+        // Deal the tasks out round-robin; stealing evens out the uneven subtrees
+        PerftJob current(threadCount, rootMoves.size(), *table);
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            current.queues[i % threadCount].push(tasks[i]);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &current;
+            busy = threadCount - 1;
+            ++generation;
+        }
+        wake.notify_all();
+        workOnJob(current, 0);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&] { return busy == 0; });
+            job = nullptr;
+        }
+
+        for (int i = 0; i < rootMoves.size(); ++i) {
+            result.divide[i].second = current.rootCounts[i].load();
+            result.nodes += result.divide[i].second;
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+PerftResult runPerft(const Position& pos, int depth, const PerftOptions& options) {
+    PerftRunner runner(options);
+    return runner.run(pos, depth);
+}
+
+// Calculate number of moves for a specific position
+void calculateMovesForPosition(const std::string& fen, int maxDepth) {
+    std::cout << "Analyzing position: " << fen << std::endl;
+
+    // Create a game logic object and set up the board from FEN
+    ChessGameLogic gameLogic;
+    gameLogic.setupFromFEN(fen);
+
+    // Show the current game state
+    std::cout << "Current turn: " << (gameLogic.getCurrentTurn() == PieceColor::WHITE ? "White" : "Black") << std::endl;
+    std::cout << "Game state: ";
+
+    switch (gameLogic.getGameState()) {
+        case GameState::ACTIVE: std::cout << "Active"; break;
+        case GameState::CHECK: std::cout << "Check"; break;
+        case GameState::CHECKMATE: std::cout << "Checkmate"; break;
+        case GameState::STALEMATE: std::cout << "Stalemate"; break;
+        case GameState::DRAW_FIFTY: std::cout << "Draw (50-move rule)"; break;
+        case GameState::DRAW_REPETITION: std::cout << "Draw (threefold repetition)"; break;
+        case GameState::DRAW_MATERIAL: std::cout << "Draw (insufficient material)"; break;
+        case GameState::DRAW_AGREEMENT: std::cout << "Draw (by agreement)"; break;
+    }
+    std::cout << std::endl;
+
+    const Position& pos = gameLogic.getPosition();
+
+    // Reference counts only apply to the standard starting position
+    const bool isStartPosition = (pos.toFEN() == START_FEN);
+
+    std::cout << "Depth test" << std::endl;
+    std::cout << "--------------------------------" << std::endl;
+
+    PerftResult result;
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        result = runPerft(pos, depth);
+
+        std::cout << "Depth " << depth << ": " << result.nodes << " moves "
+                  << "(calculated in " << std::fixed << std::setprecision(2)
+                  << result.seconds << " seconds";
+        if (result.seconds > 0.0) {
+            std::cout << ", " << static_cast<long long>(result.nodes / result.seconds) << " nps";
+        }
+        std::cout << ")";
+
+        // Compare with expected results for the standard position
+        const long long expected = isStartPosition ? expectedStartPositionNodes(depth) : -1;
+        if (expected >= 0) {
+            const bool isCorrect = (expected == result.nodes);
+            std::cout << " - " << (isCorrect ? "CORRECT" : "INCORRECT")
+                      << " (expected: " << expected << ")";
+        }
+
+        std::cout << std::endl;
+    }
+
+    // Per-move counts for the deepest run, for comparing against other engines
+    if (maxDepth >= 1) {
+        std::cout << "Divide at depth " << maxDepth << ":" << std::endl;
+        for (const auto& [move, nodes] : result.divide) {
+            std::cout << "  " << moveToUCI(move) << ": " << nodes << std::endl;
+        }
+    }
+
+    std::cout << "Analysis completed." << std::endl;
+}
+
+// Calculate number of moves for the starting position
+void calculateMovesForStartingPosition(int maxDepth) {
+    calculateMovesForPosition(START_FEN, maxDepth);
+}
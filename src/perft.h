@@ -0,0 +1,84 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "position.h"
+#include "move.h"
+
+// How a perft run is split up
+struct PerftOptions {
+    int threads = 0;            // 0 = one per hardware thread
+    int splitDepth = 2;         // Plies expanded into tasks before the workers take over
+    std::size_t hashMB = 64;    // Size of the perft hash table, 0 disables it
+};
+
+struct PerftResult {
+    long long nodes = 0;
+    double seconds = 0.0;
+    std::vector<std::pair<Move, long long>> divide;     // Leaf count below each root move
+};
+
+// Counts the leaf nodes of the legal move tree to the given depth.
+// Moves are made and unmade on pos, which is unchanged on return.
+long long perft(Position& pos, int depth);
+
+class PerftHashTable;
+struct PerftJob;
+
+/**
+ * @brief Multi-threaded perft with per-root-move ("divide") counts
+ *
+ * The tree is expanded splitDepth plies deep into tasks that a pool of
+ * threads works through, idle threads stealing from busy ones. Subtree
+ * counts are memoized in a shared lock-free table keyed by position and
+ * depth, so transpositions are only counted once.
+ *
+ * The table and the threads live as long as the runner, so a caller
+ * counting many positions (a distributed perft worker) allocates them once
+ * and later runs reuse the counts of earlier ones.
+ */
+class PerftRunner {
+public:
+    explicit PerftRunner(const PerftOptions& options = PerftOptions());
+    ~PerftRunner();
+    PerftRunner(const PerftRunner&) = delete;
+    PerftRunner& operator=(const PerftRunner&) = delete;
+
+    // Not reentrant: one run at a time
+    PerftResult run(const Position& pos, int depth);
+
+private:
+    const int splitDepth;
+    std::unique_ptr<PerftHashTable> table;
+
+    // Helper threads; the thread calling run() works as thread 0
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;       // A new job was posted, or quit
+    std::condition_variable finished;   // The last helper is done with the job
+    PerftJob* job = nullptr;
+    int generation = 0;                 // Jobs posted so far
+    int busy = 0;                       // Helpers still on the current job
+    bool quit = false;
+
+    void helperLoop(int self);
+};
+
+// A one-off run with its own table and threads
+PerftResult runPerft(const Position& pos, int depth, const PerftOptions& options = PerftOptions());
+
+// Known leaf count of the standard start position at depth, or -1 beyond the table
+long long expectedStartPositionNodes(int depth);
+
+// Menu entry points: perft each depth up to maxDepth, checking the start position against known counts
+void calculateMovesForPosition(const std::string& fen, int maxDepth);
+void calculateMovesForStartingPosition(int maxDepth);
+
+#endif // PERFT_H
@@ -0,0 +1,267 @@
+#include <chrono>
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "pgn.h"
+#include "san.h"
+#include "mapped_file.h"
+
+static bool isSpace(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Characters that end a movetext token without being part of it
+static bool endsToken(char c) {
+    return isSpace(c) || c == '{' || c == '}' || c == '(' || c == ')' || c == ';' || c == '[' || c == '$';
+}
+
+// Built once, after the attack tables exist
+static const Position& startPosition() {
+    static const Position start = [] {
+        Position pos;
+        pos.setFromFEN(START_FEN);
+        return pos;
+    }();
+    return start;
+}
+
+std::string_view PgnGame::tag(std::string_view name) const {
+    for (const PgnTag& t : tags) {
+        if (t.name == name) return t.value;
+    }
+    return {};
+}
+
+void PgnParser::skipWhitespace() {
+    while (cursor < end && isSpace(*cursor)) {
+        if (*cursor == '\n') lineStart = true;
+        ++cursor;
+    }
+}
+
+void PgnParser::skipPast(char terminator) {
+    while (cursor < end && *cursor != terminator) ++cursor;
+    if (cursor < end) ++cursor;
+}
+
+// Skips a "(...)" variation, with nested variations and comments inside it
+void PgnParser::skipVariation() {
+    int depth = 0;
+    while (cursor < end) {
+        const char c = *cursor;
+        if (c == '{') {
+            skipPast('}');
+            continue;
+        }
+        if (c == ';') {
+            skipPast('\n');
+            continue;
+        }
+        ++cursor;
+        if (c == '(') {
+            depth++;
+        } else if (c == ')' && --depth == 0) {
+            return;
+        }
+    }
+}
+
+// Reads '[Name "Value"]' with the cursor on the '['
+bool PgnParser::readTag(PgnTag& tag) {
+    ++cursor;
+    while (cursor < end && isSpace(*cursor)) ++cursor;
+    const char* nameStart = cursor;
+    while (cursor < end && !isSpace(*cursor) && *cursor != '"' && *cursor != ']') ++cursor;
+    tag.name = std::string_view(nameStart, cursor - nameStart);
+
+    while (cursor < end && isSpace(*cursor)) ++cursor;
+    tag.value = {};
+    if (cursor < end && *cursor == '"') {
+        const char* valueStart = ++cursor;
+        while (cursor < end && *cursor != '"') {
+            if (*cursor == '\\' && cursor + 1 < end) ++cursor;
+            ++cursor;
+        }
+        tag.value = std::string_view(valueStart, cursor - valueStart);
+    }
+    skipPast(']');
+    lineStart = false;
+    return !tag.name.empty();
+}
+
+void PgnParser::readMovetext(PgnGame& game) {
+    while (cursor < end) {
+        skipWhitespace();
+        if (cursor >= end) break;
+
+        const char c = *cursor;
+        if (c == '[') break;                    // The next game's tags: this one had no result
+        if (c == '%' && lineStart) {
+            skipPast('\n');
+            lineStart = true;
+            continue;
+        }
+        lineStart = false;
+        if (c == '{') {
+            skipPast('}');
+            continue;
+        }
+        if (c == ';') {
+            skipPast('\n');
+            lineStart = true;
+            continue;
+        }
+        if (c == '(') {
+            skipVariation();
+            continue;
+        }
+        if (c == ')' || c == '}') {
+            ++cursor;
+            continue;
+        }
+        if (c == '$') {
+            ++cursor;
+            while (cursor < end && isDigit(*cursor)) ++cursor;
+            continue;
+        }
+
+        const char* tokenStart = cursor;
+        while (cursor < end && !endsToken(*cursor)) ++cursor;
+        std::string_view token(tokenStart, cursor - tokenStart);
+
+        if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+            game.result = token;
+            break;
+        }
+
+        // Move numbers, possibly glued to the move ("12.e4", "12...Nf6")
+        std::size_t digits = 0;
+        while (digits < token.size() && isDigit(token[digits])) ++digits;
+        if (digits == token.size()) continue;
+        if (digits > 0 && token[digits] == '.') token.remove_prefix(digits);
+        while (!token.empty() && token.front() == '.') token.remove_prefix(1);
+
+        // After a bad move the rest of the game cannot be followed
+        if (token.empty() || !game.badToken.empty()) continue;
+
+        const Move move = parseSAN(game.end, token);
+        if (move == NO_MOVE) {
+            game.badToken = token;
+            continue;
+        }
+        game.moves.push_back(move);
+        game.end.doMove(move);
+    }
+}
+
+bool PgnParser::next(PgnGame& game) {
+    game.tags.clear();
+    game.moves.clear();
+    game.result = {};
+    game.badToken = {};
+
+    skipWhitespace();
+    if (cursor >= end) return false;
+
+    while (cursor < end && *cursor == '[') {
+        PgnTag tag;
+        if (readTag(tag)) game.tags.push_back(tag);
+        skipWhitespace();
+    }
+
+    game.start = startPosition();
+    const std::string_view fen = game.tag("FEN");
+    if (!fen.empty() && !game.start.setFromFEN(std::string(fen))) {
+        // Still consume the movetext so the next game starts in the right place
+        game.badToken = fen;
+        game.start = startPosition();
+    }
+    game.end = game.start;
+
+    readMovetext(game);
+    return true;
+}
+
+std::vector<std::string_view> splitPgn(std::string_view text, int parts) {
+    std::vector<std::string_view> pieces;
+    std::size_t begin = 0;
+    for (int i = 1; i < parts; ++i) {
+        const std::size_t target = text.size() / parts * i;
+        if (target <= begin) continue;
+
+        const std::size_t cut = text.find("\n[Event ", target);
+        if (cut == std::string_view::npos) break;
+        pieces.push_back(text.substr(begin, cut + 1 - begin));
+        begin = cut + 1;
+    }
+    pieces.push_back(text.substr(begin));
+    return pieces;
+}
+
+// Parses one piece of the file, counting into stats
+static void replayChunk(std::string_view chunk, const PgnGameCallback& onGame, PgnStats& stats) {
+    PgnParser parser(chunk);
+    PgnGame game;
+    while (parser.next(game)) {
+        // Stray text between games parses as a game without moves or tags
+        if (game.tags.empty() && game.moves.empty() && game.valid()) continue;
+
+        stats.games++;
+        stats.moves += static_cast<long long>(game.moves.size());
+        if (!game.valid()) stats.badGames++;
+        if (onGame) onGame(game);
+    }
+}
+
+bool replayPgnFile(const std::string& path, int threads, const PgnGameCallback& onGame, PgnStats& stats) {
+    MappedFile file;
+    if (!file.open(path, false)) {
+        std::cerr << "Warning: Could not map PGN file '" << path << "'" << std::endl;
+        return false;
+    }
+    const std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+
+    const std::vector<std::string_view> chunks = splitPgn(text, threads < 1 ? 1 : threads);
+    std::vector<PgnStats> chunkStats(chunks.size());
+    if (chunks.size() == 1) {
+        replayChunk(chunks[0], onGame, chunkStats[0]);
+    } else {
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&, i] { replayChunk(chunks[i], onGame, chunkStats[i]); });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    stats = PgnStats();
+    for (const PgnStats& s : chunkStats) {
+        stats.games += s.games;
+        stats.moves += s.moves;
+        stats.badGames += s.badGames;
+    }
+    return true;
+}
+
+bool runPgnReplay(const std::string& path, int threads) {
+    const auto start = std::chrono::steady_clock::now();
+    PgnStats stats;
+    if (!replayPgnFile(path, threads, nullptr, stats)) return false;
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Replayed " << stats.games << " games, " << stats.moves << " moves in " << seconds << " s ("
+              << (seconds > 0.0 ? static_cast<long long>(stats.games / seconds) : 0) << " games/s, "
+              << (seconds > 0.0 ? static_cast<long long>(stats.moves / seconds) : 0) << " moves/s)" << std::endl;
+    if (stats.badGames > 0) {
+        std::cout << stats.badGames << " games stopped at a move that did not parse" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    return true;
+}
@@ -0,0 +1,96 @@
+#ifndef PGN_H
+#define PGN_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "position.h"
+#include "move.h"
+
+// One "[Name "Value"]" pair; the value is raw, with PGN escapes (\" and \\) left in
+struct PgnTag {
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * @brief One game as read from PGN text
+ *
+ * The tag and result views point into the parsed text, so they stay valid
+ * only as long as it does. Reusing one PgnGame for every game keeps the
+ * vectors' capacity, so parsing a database does not allocate per game.
+ */
+struct PgnGame {
+    std::vector<PgnTag> tags;
+    Position start;                     // From the FEN tag, else the standard start
+    Position end;                       // After the last move read
+    std::vector<Move> moves;            // Main line only; variations are skipped
+    std::string_view result;            // "1-0", "0-1", "1/2-1/2", "*" or empty if missing
+    std::string_view badToken;          // First move that did not parse, empty if none
+
+    bool valid() const { return badToken.empty(); }
+
+    // Value of a tag, empty if the game has none by that name
+    std::string_view tag(std::string_view name) const;
+};
+
+/**
+ * @brief Reads the games of a PGN text one after another
+ *
+ * Works on a view of the text without copying: tags and moves are
+ * tokenized in place and each SAN move is resolved against the legal move
+ * generator as it is read. Comments, NAGs, variations and "%" escape lines
+ * are skipped. After an unparsable move the rest of that game's movetext is
+ * skipped and the game is flagged through badToken.
+ */
+class PgnParser {
+public:
+    explicit PgnParser(std::string_view text) : cursor(text.data()), end(text.data() + text.size()) {}
+
+    // Reads the next game into game; false once the text has no more games
+    bool next(PgnGame& game);
+
+private:
+    const char* cursor;
+    const char* end;
+    bool lineStart = true;              // Nothing but whitespace since the last newline
+
+    void skipWhitespace();
+    void skipPast(char terminator);
+    void skipVariation();
+    bool readTag(PgnTag& tag);
+    void readMovetext(PgnGame& game);
+};
+
+/**
+ * @brief Cuts PGN text into about `parts` pieces that each start at a game
+ *
+ * Cuts are made only before a line starting with "[Event ", so every piece
+ * holds whole games and can be parsed on its own thread.
+ */
+std::vector<std::string_view> splitPgn(std::string_view text, int parts);
+
+// Totals of one replay run
+struct PgnStats {
+    long long games = 0;
+    long long moves = 0;
+    long long badGames = 0;             // Games with a move that did not parse
+};
+
+// Receives every game; called from several threads at once when replaying in parallel
+using PgnGameCallback = std::function<void(const PgnGame&)>;
+
+/**
+ * @brief Memory-maps a PGN file and parses every game in it
+ *
+ * With more than one thread the file is split with splitPgn and the
+ * chunks are parsed in parallel, so games reach onGame out of order.
+ * @return False if the file could not be mapped
+ */
+bool replayPgnFile(const std::string& path, int threads, const PgnGameCallback& onGame, PgnStats& stats);
+
+// Replays a file and prints the totals and the parsing speed
+bool runPgnReplay(const std::string& path, int threads);
+
+#endif // PGN_H
@@ -7,11 +7,7 @@
 #include <utility>
 #include "pieces_placement.h"
 #include "game_logic.h"
-
-/**
- * @brief Coordinates on the chess board
- */
-using BoardPosition = std::pair<int, int>;
+#include "sprite_batch.h"
 
 /**
  * @brief Handles user interactions with the chess board
@@ -33,6 +29,7 @@ private:
     
     // Promotion state
     bool awaitingPromotion = false;
+    BoardPosition promotionFrom{-1, -1};
     BoardPosition promotionSquare{-1, -1};
     PieceColor promotionColor;
     sf::RectangleShape promotionPanel;
@@ -56,54 +53,27 @@ private:
     const sf::Color promotionPanelColor{245, 245, 245, 240}; // Light panel with transparency
     const sf::Color promotionBorderColor{70, 70, 70, 255}; // Dark border
     const sf::Color promotionHeaderColor{30, 30, 30, 240}; // Header background
+    const sf::Color promotionHighlightColor{173, 216, 230, 60}; // Behind each promotion choice
+    const sf::Color promotionOutlineColor{100, 149, 237};
+    static constexpr float PROMOTION_OUTLINE_THICKNESS = 2.0f;
     
     // Board dimensions
     float squareSize;
     
-    // Track if kings and rooks have moved (for castling)
-    bool whiteKingMoved = false;
-    bool blackKingMoved = false;
-    bool whiteKingsideRookMoved = false;
-    bool whiteQueensideRookMoved = false;
-    bool blackKingsideRookMoved = false;
-    bool blackQueensideRookMoved = false;
-    
     // Private methods
     void calculateLegalMoves();
-    std::vector<BoardPosition> getPawnMoves(const BoardPosition& pos, const ChessPiece& piece);
-    std::vector<BoardPosition> getRookMoves(const BoardPosition& pos, const ChessPiece& piece);
-    std::vector<BoardPosition> getKnightMoves(const BoardPosition& pos, const ChessPiece& piece);
-    std::vector<BoardPosition> getBishopMoves(const BoardPosition& pos, const ChessPiece& piece);
-    std::vector<BoardPosition> getQueenMoves(const BoardPosition& pos, const ChessPiece& piece);
-    
-    // Helper method for sliding pieces (rook, bishop, queen)
-    void addMovesInDirection(std::vector<BoardPosition>& moves, const BoardPosition& startPos, 
-                             int dirX, int dirY, const ChessPiece& piece);
-                             
+    
     // Promotion methods
     void showPromotionOptions(const BoardPosition& square, PieceColor color);
     void executePromotion(PieceType promotionType);
-    void executePromotion(const BoardPosition& from, const BoardPosition& to);
     
-    // Executes a move with special rule handling
+    // Plays a move through the game logic and refreshes the sprites
     void movePiece(const BoardPosition& from, const BoardPosition& to);
-    void positionPieceSprite(const BoardPosition& pos);
-    void executeCastling(const BoardPosition& from, const BoardPosition& to);
-    bool isPromotionMove(const BoardPosition& from, const BoardPosition& to) const;
-    
-    // Add King moves method
-    std::vector<BoardPosition> getKingMoves(const BoardPosition& pos, const ChessPiece& piece);
-    
-    // Helper for castling
-    bool canCastle(const BoardPosition& kingPos, int direction, const ChessPiece& king);
-    
-    // Add check for castling move
-    bool isCastlingMove(const BoardPosition& from, const BoardPosition& to) const;
 
 public:
     /**
      * @brief Constructor
-     * @param piecesRef Reference to the map of chess pieces
+     * @param piecesRef Reference to the map of chess pieces, kept in sync with the game logic
      * @param gameLogicRef Reference to the game logic handler
      * @param squareSz Size of each square on the chess board
      */
@@ -126,10 +96,15 @@ public:
     void update(float deltaTime);
     
     /**
-     * @brief Draws interaction visuals (highlights, legal moves, etc.)
-     * @param window The render window to draw to
+     * @brief Adds interaction visuals (highlights, legal moves, etc.) to the board's batch
+     * @param batch Batch drawn with the piece atlas
+     */
+    void appendTo(SpriteBatch& batch) const;
+    
+    /**
+     * @brief Whether the visuals change from frame to frame (the selection pulses)
      */
-    void draw(sf::RenderWindow& window);
+    bool isAnimating() const { return selectedSquare.first != -1; }
     
     /**
      * @brief Gets the currently selected square
@@ -160,7 +135,7 @@ public:
     /**
      * @brief Resets the game to the starting position
      */
-    void resetGame() { gameLogic.resetGame(); }
+    void resetGame();
     
     /**
      * @brief Offers a draw to the opponent
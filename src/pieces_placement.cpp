@@ -1,6 +1,13 @@
 #include "pieces_placement.h"
+#include "position.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
 #include <unordered_map>
 
 // Initialize static instance pointer
@@ -14,16 +21,72 @@ PieceTextureManager& PieceTextureManager::getInstance() {
     return *instance;
 }
 
-// Get a texture from the manager
-const sf::Texture* PieceTextureManager::getTexture(const std::string& key) const {
-    auto it = textures.find(key);
-    return it != textures.end() ? &(it->second) : nullptr;
+// Height of the opaque white strip below the piece cells
+static constexpr int SOLID_STRIP_HEIGHT = 4;
+
+// Decoded atlas file: this tag, width and height (little-endian 32-bit), then RGBA rows
+static const char DECODED_ATLAS_TAG[8] = {'P', 'H', 'A', 'T', 'L', 'A', 'S', '1'};
+static constexpr std::size_t DECODED_ATLAS_HEADER = sizeof(DECODED_ATLAS_TAG) + 8;
+
+static std::uint32_t readLittleEndian32(const unsigned char* bytes) {
+    return static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8) |
+           (static_cast<std::uint32_t>(bytes[2]) << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+}
+
+static void writeLittleEndian32(std::ofstream& out, std::uint32_t value) {
+    const char bytes[4] = {static_cast<char>(value), static_cast<char>(value >> 8),
+                           static_cast<char>(value >> 16), static_cast<char>(value >> 24)};
+    out.write(bytes, sizeof(bytes));
+}
+
+// Saves the decoded atlas so the next start can skip PNG decoding; failures only cost that
+static void saveDecodedAtlas(const std::string& path, const sf::Image& image) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return;
+    out.write(DECODED_ATLAS_TAG, sizeof(DECODED_ATLAS_TAG));
+    writeLittleEndian32(out, image.getSize().x);
+    writeLittleEndian32(out, image.getSize().y);
+    out.write(reinterpret_cast<const char*>(image.getPixelsPtr()),
+              static_cast<std::streamsize>(image.getSize().x) * image.getSize().y * 4);
+    if (!out) {
+        out.close();
+        std::remove(path.c_str());
+    }
+}
+
+// True if both files exist and the first was written before the second, i.e. is stale
+static bool isOlderThan(const std::string& path, const std::string& source) {
+    std::error_code error;
+    const auto written = std::filesystem::last_write_time(path, error);
+    if (error) return false;
+    const auto sourceWritten = std::filesystem::last_write_time(source, error);
+    return !error && written < sourceWritten;
 }
 
-// Load all piece textures
+// Uploads a decoded atlas of the expected size straight from the mapped file
+bool PieceTextureManager::loadDecodedAtlas(const std::string& path, unsigned int width, unsigned int height) {
+    MappedFile file;
+    if (!file.open(path, false)) return false;
+
+    const unsigned char* bytes = file.data();
+    if (file.size() != DECODED_ATLAS_HEADER + static_cast<std::size_t>(width) * height * 4 ||
+        std::memcmp(bytes, DECODED_ATLAS_TAG, sizeof(DECODED_ATLAS_TAG)) != 0 ||
+        readLittleEndian32(bytes + 8) != width || readLittleEndian32(bytes + 12) != height) {
+        std::cerr << "Warning: Ignoring decoded atlas '" << path << "' of the wrong size" << std::endl;
+        return false;
+    }
+
+    if (!atlas.create(width, height)) return false;
+    atlas.update(bytes + DECODED_ATLAS_HEADER);
+    return true;
+}
+
+// Load the piece atlas (or build it from the separate piece images)
 bool PieceTextureManager::loadTextures(float scaleFactor) {
     currentScale = scaleFactor;
-    textures.clear();
+    
+    // Later board windows reuse the texture and only change the scale
+    if (loaded) return true;
     
     // Check if pieces directory exists
     std::filesystem::path piecesDir("./pieces");
@@ -53,7 +116,7 @@ bool PieceTextureManager::loadTextures(float scaleFactor) {
                 
                 std::cerr << "Pieces directory created at: " << std::filesystem::absolute(piecesDir) << std::endl;
                 std::cerr << "Please copy chess piece PNG images to this directory." << std::endl;
-                std::cerr << "Required files: white-pawn.png, white-rook.png, etc." << std::endl;
+                std::cerr << "Required files: atlas.png, or white-pawn.png, white-rook.png, etc." << std::endl;
             } catch (const std::exception& e) {
                 std::cerr << "Failed to create pieces directory: " << e.what() << std::endl;
             }
@@ -61,89 +124,101 @@ bool PieceTextureManager::loadTextures(float scaleFactor) {
         }
     }
     
-    // Piece filenames array for faster iteration
+    // Piece filenames in atlas order (our PieceType order, white first)
     static const std::string pieceNames[] = {
         "white-pawn", "white-rook", "white-knight", "white-bishop", "white-queen", "white-king",
         "black-pawn", "black-rook", "black-knight", "black-bishop", "black-queen", "black-king"
     };
+    constexpr unsigned int ATLAS_COLUMNS = 3;
+    constexpr unsigned int ATLAS_WIDTH = ATLAS_COLUMNS * CELL_SIZE;
+    constexpr unsigned int ATLAS_HEIGHT = (COLOR_COUNT * PIECE_TYPE_COUNT / ATLAS_COLUMNS) * CELL_SIZE;
     
-    bool allLoaded = true;
-    bool anyLoaded = false;
-    
-    // Create fallback textures for missing pieces
-    sf::Texture fallbackWhite;
-    sf::Texture fallbackBlack;
+    // The piece cells plus the white strip, transparent everywhere else
+    sf::Image atlasImage;
+    atlasImage.create(ATLAS_WIDTH, ATLAS_HEIGHT + SOLID_STRIP_HEIGHT, sf::Color::Transparent);
+    for (unsigned int x = 0; x < SOLID_STRIP_HEIGHT; ++x) {
+        for (unsigned int y = 0; y < SOLID_STRIP_HEIGHT; ++y) {
+            atlasImage.setPixel(x, ATLAS_HEIGHT + y, sf::Color::White);
+        }
+    }
+    solidRect = sf::IntRect(0, ATLAS_HEIGHT, SOLID_STRIP_HEIGHT, SOLID_STRIP_HEIGHT);
     
-    // Create simple fallback textures (10x10 white/black squares)
-    sf::Image whiteImg;
-    sf::Image blackImg;
-    whiteImg.create(20, 20, sf::Color::White);
-    blackImg.create(20, 20, sf::Color::Black);
+    for (int i = 0; i < COLOR_COUNT * PIECE_TYPE_COUNT; ++i) {
+        pieceRects[i / PIECE_TYPE_COUNT][i % PIECE_TYPE_COUNT] =
+            sf::IntRect((i % ATLAS_COLUMNS) * CELL_SIZE, (i / ATLAS_COLUMNS) * CELL_SIZE, CELL_SIZE, CELL_SIZE);
+    }
     
-    // Add a simple border to fallback textures to make them visible on both square colors
-    for (unsigned int x = 0; x < 20; ++x) {
-        for (unsigned int y = 0; y < 20; ++y) {
-            if (x < 2 || x > 17 || y < 2 || y > 17) {
-                whiteImg.setPixel(x, y, sf::Color::Black);
-                blackImg.setPixel(x, y, sf::Color::White);
-            }
-        }
+    const std::string atlasPath = piecesDir.string() + "/atlas.png";
+    const std::string decodedPath = piecesDir.string() + "/atlas.rgba";
+    if (!isOlderThan(decodedPath, atlasPath) &&
+        loadDecodedAtlas(decodedPath, ATLAS_WIDTH, ATLAS_HEIGHT + SOLID_STRIP_HEIGHT)) {
+        atlas.setSmooth(true);
+        loaded = true;
+        return true;
     }
     
-    fallbackWhite.loadFromImage(whiteImg);
-    fallbackBlack.loadFromImage(blackImg);
+    bool anyLoaded = false;
+    bool allLoaded = true;
     
-    // Load each texture
-    for (const auto& piece : pieceNames) {
-        // Try multiple paths for each piece
-        std::vector<std::string> possiblePaths = {
-            piecesDir.string() + "/" + piece + ".png",
-            "./pieces/" + piece + ".png",
-            "../pieces/" + piece + ".png",
-            "../../pieces/" + piece + ".png",
-            "build/exe/pieces/" + piece + ".png"
-        };
+    sf::Image packedAtlas;
+    if (std::filesystem::exists(atlasPath) && packedAtlas.loadFromFile(atlasPath) &&
+        packedAtlas.getSize().x == ATLAS_WIDTH && packedAtlas.getSize().y == ATLAS_HEIGHT) {
+        atlasImage.copy(packedAtlas, 0, 0);
+        saveDecodedAtlas(decodedPath, atlasImage);
+        anyLoaded = true;
+    } else {
+        std::cerr << "Piece atlas not found, building it from the separate images" << std::endl;
         
-        bool loaded = false;
-        for (const auto& filename : possiblePaths) {
-            if (std::filesystem::exists(filename)) {
-                sf::Texture texture;
-                if (texture.loadFromFile(filename)) {
-                    texture.setSmooth(true); // Enable smooth scaling
-                    textures[piece] = std::move(texture);
-                    loaded = true;
-                    anyLoaded = true;
-                    break;
+        // Simple fallback images for missing pieces (20x20 white/black squares)
+        sf::Image fallbackWhite;
+        sf::Image fallbackBlack;
+        fallbackWhite.create(20, 20, sf::Color::White);
+        fallbackBlack.create(20, 20, sf::Color::Black);
+        
+        // Add a simple border to fallback images to make them visible on both square colors
+        for (unsigned int x = 0; x < 20; ++x) {
+            for (unsigned int y = 0; y < 20; ++y) {
+                if (x < 2 || x > 17 || y < 2 || y > 17) {
+                    fallbackWhite.setPixel(x, y, sf::Color::Black);
+                    fallbackBlack.setPixel(x, y, sf::Color::White);
                 }
             }
         }
         
-        if (!loaded) {
-            std::cerr << "Texture file not found for: " << piece << std::endl;
-            // Use fallback texture
-            if (piece.find("white") != std::string::npos) {
-                textures[piece] = fallbackWhite;
+        for (int i = 0; i < COLOR_COUNT * PIECE_TYPE_COUNT; ++i) {
+            sf::IntRect& rect = pieceRects[i / PIECE_TYPE_COUNT][i % PIECE_TYPE_COUNT];
+            const std::string filename = piecesDir.string() + "/" + pieceNames[i] + ".png";
+            
+            sf::Image image;
+            const bool loaded = std::filesystem::exists(filename) && image.loadFromFile(filename);
+            if (!loaded) {
+                std::cerr << "Texture file not found for: " << pieceNames[i] << std::endl;
+                image = (i < PIECE_TYPE_COUNT) ? fallbackWhite : fallbackBlack;
+                allLoaded = false;
             } else {
-                textures[piece] = fallbackBlack;
+                anyLoaded = true;
             }
-            allLoaded = false;
+            
+            // Images larger than a cell are cropped to it
+            const int width = std::min<int>(image.getSize().x, CELL_SIZE);
+            const int height = std::min<int>(image.getSize().y, CELL_SIZE);
+            atlasImage.copy(image, rect.left, rect.top, sf::IntRect(0, 0, width, height));
+            rect.width = width;
+            rect.height = height;
         }
     }
     
+    if (!atlas.loadFromImage(atlasImage)) {
+        std::cerr << "Error: Could not create the piece atlas texture." << std::endl;
+        return false;
+    }
+    atlas.setSmooth(true); // Enable smooth scaling
+    
     // If no pieces were loaded but we created fallbacks, we can still continue
-    return anyLoaded || !allLoaded;
+    loaded = anyLoaded || !allLoaded;
+    return loaded;
 }
 
-// Fast lookup mapping of FEN characters to piece types - using unordered_map for better performance
-const std::unordered_map<char, PieceType> FEN_TO_PIECE_TYPE = {
-    {'p', PieceType::PAWN},   {'P', PieceType::PAWN},
-    {'r', PieceType::ROOK},   {'R', PieceType::ROOK},
-    {'n', PieceType::KNIGHT}, {'N', PieceType::KNIGHT},
-    {'b', PieceType::BISHOP}, {'B', PieceType::BISHOP},
-    {'q', PieceType::QUEEN},  {'Q', PieceType::QUEEN},
-    {'k', PieceType::KING},   {'K', PieceType::KING}
-};
-
 // Backwards compatibility function
 bool loadPieceTextures(float scaleFactor) {
     return PieceTextureManager::getInstance().loadTextures(scaleFactor);
@@ -172,127 +247,47 @@ std::string getTextureKeyFromFEN(char fenChar) {
     return ""; // Invalid character
 }
 
-// Function to set up pieces according to FEN notation
-void setupPositionFromFEN(std::map<std::pair<int, int>, ChessPiece>& pieces, const std::string& fen) {
-    pieces.clear();
+// Build a piece with its image scaled and centered on the given square
+static ChessPiece makePiece(PieceType type, PieceColor color, int col, int row) {
     constexpr float SQUARE_SIZE = 100.0f;
-    auto& textureManager = PieceTextureManager::getInstance();
-    
-    // Parse board position (first part of FEN)
-    std::string boardFEN;
-    size_t spacePos = fen.find(' ');
-    if (spacePos != std::string::npos) {
-        boardFEN = fen.substr(0, spacePos);
-    } else {
-        boardFEN = fen; // Use the whole string if no space found
-    }
-    
-    int row = 0;
-    int col = 0;
+    const float size = SQUARE_SIZE * PieceTextureManager::getInstance().getScale();
+    return ChessPiece{
+        type,
+        color,
+        pieceBounds((col + 0.5f) * SQUARE_SIZE, (row + 0.5f) * SQUARE_SIZE, size)
+    };
+}
+
+// Rebuild the piece map from an engine position
+void syncPiecesFromPosition(std::map<std::pair<int, int>, ChessPiece>& pieces, const Position& position) {
+    pieces.clear();
     
-    // Pre-check for valid FEN string (should have 8 rows)
-    int rowCount = 1; // Start with 1 because we count separators
-    for (char c : boardFEN) {
-        if (c == '/') rowCount++;
+    Bitboard occupied = position.pieces();
+    while (occupied) {
+        const int sq = popLsb(occupied);
+        PieceType type;
+        PieceColor color;
+        position.pieceAt(sq, type, color);
+        
+        const BoardPosition pos = toBoardPosition(sq);
+        pieces[pos] = makePiece(type, color, pos.first, pos.second);
     }
-    
-    if (rowCount != 8) {
-        std::cerr << "Warning: FEN string does not have 8 rows. It has " << rowCount << " rows." << std::endl;
-        // Continue anyway - we'll handle this gracefully
+}
+
+// Function to set up pieces according to FEN notation
+void setupPositionFromFEN(std::map<std::pair<int, int>, ChessPiece>& pieces, const std::string& fen) {
+    Position position;
+    if (!position.setFromFEN(fen)) {
+        std::cerr << "Warning: Invalid FEN string '" << fen << "'" << std::endl;
     }
     
-    auto charIt = boardFEN.begin();
-    auto endIt = boardFEN.end();
-    
-    // Row and column bounds checking
-    while (charIt != endIt && row < 8) {
-        char c = *charIt++;
-        
-        if (c == '/') {
-            // Move to next row, reset column
-            row++;
-            col = 0;
-            
-            // Skip invalid rows
-            if (row >= 8) break;
-        } else if (std::isdigit(c)) {
-            // Skip empty squares
-            int emptyCount = c - '0';
-            
-            // Check for invalid column bounds
-            if (col + emptyCount > 8) {
-                std::cerr << "Warning: FEN string specifies too many columns in row " << row + 1 << std::endl;
-                // Clamp to valid range
-                emptyCount = 8 - col;
-            }
-            
-            col += emptyCount;
-        } else if (std::isalpha(c)) {
-            // Place a piece (only if within bounds)
-            if (col < 8) {
-                // Check if valid piece character
-                auto fenIt = FEN_TO_PIECE_TYPE.find(c);
-                if (fenIt == FEN_TO_PIECE_TYPE.end()) {
-                    std::cerr << "Warning: Invalid piece character '" << c << "' in FEN string" << std::endl;
-                    col++; // Skip this character
-                    continue;
-                }
-                
-                std::string textureKey = getTextureKeyFromFEN(c);
-                const sf::Texture* texture = textureManager.getTexture(textureKey);
-                
-                if (!textureKey.empty()) {
-                    ChessPiece piece{
-                        fenIt->second,
-                        getColorFromFEN(c),
-                        sf::Sprite()  // Initialize with empty sprite in case texture is missing
-                    };
-                    
-                    // Only set up sprite if texture is available
-                    if (texture) {
-                        piece.sprite = sf::Sprite(*texture);
-                        
-                        // Direct calculation of scaling and positioning for performance
-                        float textureWidth = texture->getSize().x;
-                        float textureHeight = texture->getSize().y;
-                        float scaleFactor = textureManager.getScale();
-                        float scaleX = (SQUARE_SIZE / textureWidth) * scaleFactor;
-                        float scaleY = (SQUARE_SIZE / textureHeight) * scaleFactor;
-                        
-                        piece.sprite.setScale(scaleX, scaleY);
-                        
-                        // Position the piece with center alignment
-                        float offsetX = (SQUARE_SIZE - (textureWidth * scaleX)) / 2;
-                        float offsetY = (SQUARE_SIZE - (textureHeight * scaleY)) / 2;
-                        
-                        piece.sprite.setPosition(
-                            col * SQUARE_SIZE + offsetX,
-                            row * SQUARE_SIZE + offsetY
-                        );
-                    }
-                    
-                    pieces[{col, row}] = std::move(piece);
-                }
-                
-                col++;
-            } else {
-                std::cerr << "Warning: FEN string has too many pieces in row " << row + 1 << std::endl;
-                // Skip to next row
-                while (charIt != endIt && *charIt != '/') charIt++;
-                if (charIt != endIt) charIt++; // Skip the '/'
-                row++;
-                col = 0;
-            }
-        } else {
-            // Skip invalid characters
-            std::cerr << "Warning: Invalid character '" << c << "' in FEN string" << std::endl;
-        }
-    }
+    syncPiecesFromPosition(pieces, position);
 }
 
-// Function to draw pieces on the board
-void drawPieces(sf::RenderWindow& window, const std::map<std::pair<int, int>, ChessPiece>& pieces) {
+// Add the pieces to a batch drawn with the piece atlas
+void appendPieces(SpriteBatch& batch, const std::map<std::pair<int, int>, ChessPiece>& pieces) {
+    const auto& textureManager = PieceTextureManager::getInstance();
     for (const auto& [position, piece] : pieces) {
-        window.draw(piece.sprite);
+        batch.addTexturedRect(piece.bounds, textureManager.getPieceRect(piece.type, piece.color));
     }
-} 
\ No newline at end of file
+}
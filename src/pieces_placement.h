@@ -5,38 +5,68 @@
 #include <map>
 #include <string>
 #include <vector>
+#include "chess_types.h"
+#include "sprite_batch.h"
 
-// Piece type and color enumerations
-enum class PieceType { PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING };
-enum class PieceColor { WHITE, BLACK };
+class Position;
 
 // Chess piece structure
 struct ChessPiece {
     PieceType type;
     PieceColor color;
-    sf::Sprite sprite;
+    sf::FloatRect bounds; // Where the piece's image goes on screen
 };
 
-// Singleton texture manager for chess pieces
+/**
+ * @brief Singleton holding every piece image in one atlas texture
+ *
+ * pieces/atlas.png holds the twelve 128x128 piece images in a 3x4 grid,
+ * white pawn, rook, knight, bishop, queen, king and then the same for black.
+ * Without it the atlas is assembled from the separate piece files. A small
+ * opaque white area below the pieces serves solid rectangles, so the whole
+ * board can be drawn from this one texture.
+ *
+ * The first time atlas.png is decoded, the decoded pixels are written next
+ * to it as atlas.rgba. Later starts map that file and upload it straight
+ * into the texture without decoding anything. The texture is loaded once,
+ * on the first call to loadTextures(), and kept for every later board window.
+ */
 class PieceTextureManager {
 private:
     static PieceTextureManager* instance;
-    std::map<std::string, sf::Texture> textures;
+    sf::Texture atlas;
+    sf::IntRect pieceRects[COLOR_COUNT][PIECE_TYPE_COUNT];
+    sf::IntRect solidRect;
     float currentScale;
+    bool loaded = false;
     
     PieceTextureManager() : currentScale(1.0f) {}
     
+    bool loadDecodedAtlas(const std::string& path, unsigned int width, unsigned int height);
+    
 public:
+    static constexpr int CELL_SIZE = 128;
+    
     static PieceTextureManager& getInstance();
     bool loadTextures(float scaleFactor = 1.0f);
-    const sf::Texture* getTexture(const std::string& key) const;
+    const sf::Texture& getAtlas() const { return atlas; }
+    const sf::IntRect& getPieceRect(PieceType type, PieceColor color) const {
+        return pieceRects[static_cast<int>(color)][static_cast<int>(type)];
+    }
+    const sf::IntRect& getSolidRect() const { return solidRect; }
     float getScale() const { return currentScale; }
 };
 
 // Position setup and drawing
 void setupPositionFromFEN(std::map<std::pair<int, int>, ChessPiece>& pieces, 
                           const std::string& fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-void drawPieces(sf::RenderWindow& window, const std::map<std::pair<int, int>, ChessPiece>& pieces);
+void syncPiecesFromPosition(std::map<std::pair<int, int>, ChessPiece>& pieces, const Position& position);
+void appendPieces(SpriteBatch& batch, const std::map<std::pair<int, int>, ChessPiece>& pieces);
+
+// Screen rectangle of a piece image of the given size centered on a point
+inline sf::FloatRect pieceBounds(float centerX, float centerY, float size) {
+    return sf::FloatRect(centerX - size / 2, centerY - size / 2, size, size);
+}
 
 // Helper functions for FEN notation
 PieceColor getColorFromFEN(char fenChar);
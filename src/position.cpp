@@ -0,0 +1,414 @@
+#include "position.h"
+#include <cctype>
+#include <sstream>
+
+static_assert(sizeof(Position) <= 128, "Position should fit in two cache lines");
+
+// Castling rights that survive a move touching each square
+// (moving or capturing on a1/h1/e1/a8/h8/e8 clears the matching rights)
+static const std::uint8_t CASTLING_MASK[64] = {
+    13, 15, 15, 15, 12, 15, 15, 14,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+     7, 15, 15, 15,  3, 15, 15, 11
+};
+
+// FEN piece letters indexed by PieceType
+static const char PIECE_CHARS[] = "prnbqk";
+
+Position::Position() {
+    clear();
+}
+
+void Position::clear() {
+    for (auto& bb : byType) bb = 0;
+    for (auto& bb : byColor) bb = 0;
+    side = PieceColor::WHITE;
+    castling = 0;
+    epSquare = NO_SQUARE;
+    halfmove = 0;
+    fullmove = 1;
+    key = 0;
+    psq = 0;
+    phase = 0;
+}
+
+void Position::putPiece(int sq, PieceType type, PieceColor color) {
+    const Bitboard bb = squareBB(sq);
+    byType[static_cast<int>(type)] |= bb;
+    byColor[static_cast<int>(color)] |= bb;
+    key ^= pieceKey(sq, type, color);
+    psq += pieceSquareScore(sq, type, color);
+    phase += PHASE_WEIGHTS[static_cast<int>(type)];
+}
+
+void Position::removePiece(int sq) {
+    PieceType type;
+    PieceColor color;
+    if (!pieceAt(sq, type, color)) return;
+    key ^= pieceKey(sq, type, color);
+    psq -= pieceSquareScore(sq, type, color);
+    phase -= PHASE_WEIGHTS[static_cast<int>(type)];
+
+    const Bitboard mask = ~squareBB(sq);
+    for (auto& bb : byType) bb &= mask;
+    for (auto& bb : byColor) bb &= mask;
+}
+
+PieceType Position::typeOn(int sq) const {
+    const Bitboard bb = squareBB(sq);
+    for (int t = 0; t < PIECE_TYPE_COUNT; ++t) {
+        if (byType[t] & bb) return static_cast<PieceType>(t);
+    }
+    return PieceType::PAWN; // Callers check the square is occupied first
+}
+
+bool Position::pieceAt(int sq, PieceType& type, PieceColor& color) const {
+    const Bitboard bb = squareBB(sq);
+    if (!(pieces() & bb)) return false;
+    color = (byColor[0] & bb) ? PieceColor::WHITE : PieceColor::BLACK;
+    type = typeOn(sq);
+    return true;
+}
+
+int Position::kingSquare(PieceColor color) const {
+    const Bitboard king = pieces(color, PieceType::KING);
+    return king ? lsb(king) : NO_SQUARE;
+}
+
+template <PieceColor Them>
+bool Position::isAttackedBy(int sq) const {
+    const Bitboard them = pieces(Them);
+    const Bitboard occupied = pieces();
+
+    // A pawn of the defending color on sq attacks exactly the squares
+    // an attacking pawn would have to stand on
+    if (pawnAttacks<opposite(Them)>(sq) & them & pieces(PieceType::PAWN)) return true;
+    if (knightAttacks(sq) & them & pieces(PieceType::KNIGHT)) return true;
+    if (kingAttacks(sq) & them & pieces(PieceType::KING)) return true;
+
+    const Bitboard queens = pieces(PieceType::QUEEN);
+    if (rookAttacks(sq, occupied) & them & (pieces(PieceType::ROOK) | queens)) return true;
+    if (bishopAttacks(sq, occupied) & them & (pieces(PieceType::BISHOP) | queens)) return true;
+
+    return false;
+}
+
+bool Position::isSquareAttacked(int sq, PieceColor attackingColor) const {
+    if (sq == NO_SQUARE) return false;
+    return attackingColor == PieceColor::WHITE ? isAttackedBy<PieceColor::WHITE>(sq)
+                                               : isAttackedBy<PieceColor::BLACK>(sq);
+}
+
+Bitboard Position::attackersTo(int sq, Bitboard occupied) const {
+    const Bitboard queens = pieces(PieceType::QUEEN);
+    return (pawnAttacks(PieceColor::WHITE, sq) & pieces(PieceColor::BLACK, PieceType::PAWN)) |
+           (pawnAttacks(PieceColor::BLACK, sq) & pieces(PieceColor::WHITE, PieceType::PAWN)) |
+           (knightAttacks(sq) & pieces(PieceType::KNIGHT)) |
+           (kingAttacks(sq) & pieces(PieceType::KING)) |
+           (rookAttacks(sq, occupied) & (pieces(PieceType::ROOK) | queens)) |
+           (bishopAttacks(sq, occupied) & (pieces(PieceType::BISHOP) | queens));
+}
+
+template <PieceColor Us>
+void Position::makeMoveAs(Move move, UndoInfo& undo) {
+    constexpr PieceColor us = Us;
+    constexpr PieceColor them = opposite(Us);
+    const int from = moveFrom(move);
+    const int to = moveTo(move);
+    const int flags = moveFlags(move);
+    const PieceType moving = typeOn(from);
+
+    Key k = key ^ ZOBRIST_SIDE_TO_MOVE_KEY;
+
+    undo.key = key;
+    undo.psq = psq;
+    undo.phase = phase;
+    undo.captured = NO_CAPTURE;
+    undo.castling = castling;
+    undo.epSquare = epSquare;
+    undo.halfmove = halfmove;
+
+    // Remove the captured piece
+    if (flags == EP_CAPTURE) {
+        const int capturedSq = (Us == PieceColor::WHITE) ? to - 8 : to + 8;
+        togglePiece(capturedSq, PieceType::PAWN, them);
+        k ^= pieceKey(capturedSq, PieceType::PAWN, them);
+        psq -= pieceSquareScore(capturedSq, PieceType::PAWN, them);
+        undo.captured = static_cast<std::uint8_t>(PieceType::PAWN);
+    } else if (flags & CAPTURE) {
+        const PieceType captured = typeOn(to);
+        togglePiece(to, captured, them);
+        k ^= pieceKey(to, captured, them);
+        psq -= pieceSquareScore(to, captured, them);
+        phase -= PHASE_WEIGHTS[static_cast<int>(captured)];
+        undo.captured = static_cast<std::uint8_t>(captured);
+    }
+
+    // Move the piece (promotions arrive as the new piece)
+    const PieceType placed = (flags & PROMOTION) ? promotionType(move) : moving;
+    togglePiece(from, moving, us);
+    togglePiece(to, placed, us);
+    k ^= pieceKey(from, moving, us) ^ pieceKey(to, placed, us);
+    psq += pieceSquareScore(to, placed, us) - pieceSquareScore(from, moving, us);
+    phase += PHASE_WEIGHTS[static_cast<int>(placed)] - PHASE_WEIGHTS[static_cast<int>(moving)];
+
+    // Castling moves the rook as well
+    if (flags == KING_CASTLE) {
+        togglePiece(to + 1, PieceType::ROOK, us);
+        togglePiece(to - 1, PieceType::ROOK, us);
+        k ^= pieceKey(to + 1, PieceType::ROOK, us) ^ pieceKey(to - 1, PieceType::ROOK, us);
+        psq += pieceSquareScore(to - 1, PieceType::ROOK, us) - pieceSquareScore(to + 1, PieceType::ROOK, us);
+    } else if (flags == QUEEN_CASTLE) {
+        togglePiece(to - 2, PieceType::ROOK, us);
+        togglePiece(to + 1, PieceType::ROOK, us);
+        k ^= pieceKey(to - 2, PieceType::ROOK, us) ^ pieceKey(to + 1, PieceType::ROOK, us);
+        psq += pieceSquareScore(to + 1, PieceType::ROOK, us) - pieceSquareScore(to - 2, PieceType::ROOK, us);
+    }
+
+    k ^= ZOBRIST_CASTLING_KEYS[castling];
+    castling &= CASTLING_MASK[from] & CASTLING_MASK[to];
+    k ^= ZOBRIST_CASTLING_KEYS[castling];
+
+    // Only record an en passant square when an enemy pawn can actually use it,
+    // so that otherwise identical positions compare equal
+    if (epSquare != NO_SQUARE) {
+        k ^= ZOBRIST_EP_FILE_KEYS[fileOf(epSquare)];
+        epSquare = NO_SQUARE;
+    }
+    if (flags == DOUBLE_PUSH) {
+        const int ep = (from + to) / 2;
+        if (pawnAttacks<Us>(ep) & pieces(them, PieceType::PAWN)) {
+            epSquare = static_cast<std::uint8_t>(ep);
+            k ^= ZOBRIST_EP_FILE_KEYS[fileOf(ep)];
+        }
+    }
+
+    if (moving == PieceType::PAWN || (flags & CAPTURE)) {
+        halfmove = 0;
+    } else if (halfmove < 255) {
+        halfmove++;
+    }
+
+    if constexpr (Us == PieceColor::BLACK) {
+        fullmove++;
+    }
+
+    side = them;
+    key = k;
+}
+
+void Position::makeMove(Move move, UndoInfo& undo) {
+    if (side == PieceColor::WHITE) {
+        makeMoveAs<PieceColor::WHITE>(move, undo);
+    } else {
+        makeMoveAs<PieceColor::BLACK>(move, undo);
+    }
+}
+
+template <PieceColor Us>
+void Position::unmakeMoveAs(Move move, const UndoInfo& undo) {
+    constexpr PieceColor us = Us;
+    constexpr PieceColor them = opposite(Us);
+    const int from = moveFrom(move);
+    const int to = moveTo(move);
+    const int flags = moveFlags(move);
+    const PieceType placed = typeOn(to);
+    const PieceType moved = (flags & PROMOTION) ? PieceType::PAWN : placed;
+
+    // Put the moving piece back
+    togglePiece(to, placed, us);
+    togglePiece(from, moved, us);
+
+    // Put the rook back after castling
+    if (flags == KING_CASTLE) {
+        togglePiece(to - 1, PieceType::ROOK, us);
+        togglePiece(to + 1, PieceType::ROOK, us);
+    } else if (flags == QUEEN_CASTLE) {
+        togglePiece(to + 1, PieceType::ROOK, us);
+        togglePiece(to - 2, PieceType::ROOK, us);
+    }
+
+    // Restore the captured piece
+    if (undo.captured != NO_CAPTURE) {
+        const int capturedSq = (flags == EP_CAPTURE) ? (Us == PieceColor::WHITE ? to - 8 : to + 8) : to;
+        togglePiece(capturedSq, static_cast<PieceType>(undo.captured), them);
+    }
+
+    castling = undo.castling;
+    epSquare = undo.epSquare;
+    halfmove = undo.halfmove;
+    key = undo.key;
+    psq = undo.psq;
+    phase = undo.phase;
+
+    if constexpr (Us == PieceColor::BLACK) {
+        fullmove--;
+    }
+
+    side = us;
+}
+
+// The mover is the side that is no longer to move
+void Position::unmakeMove(Move move, const UndoInfo& undo) {
+    if (side == PieceColor::BLACK) {
+        unmakeMoveAs<PieceColor::WHITE>(move, undo);
+    } else {
+        unmakeMoveAs<PieceColor::BLACK>(move, undo);
+    }
+}
+
+void Position::makeNullMove(UndoInfo& undo) {
+    undo.key = key;
+    undo.psq = psq;
+    undo.phase = phase;
+    undo.captured = NO_CAPTURE;
+    undo.castling = castling;
+    undo.epSquare = epSquare;
+    undo.halfmove = halfmove;
+
+    key ^= ZOBRIST_SIDE_TO_MOVE_KEY;
+    if (epSquare != NO_SQUARE) {
+        key ^= ZOBRIST_EP_FILE_KEYS[fileOf(epSquare)];
+        epSquare = NO_SQUARE;
+    }
+    halfmove = 0;
+    side = opposite(side);
+}
+
+void Position::unmakeNullMove(const UndoInfo& undo) {
+    key = undo.key;
+    epSquare = undo.epSquare;
+    halfmove = undo.halfmove;
+    side = opposite(side);
+}
+
+bool Position::setFromFEN(const std::string& fen) {
+    clear();
+
+    std::istringstream fenStream(fen);
+    std::string placement, activeColor, castlingPart, epPart;
+    int halfmoveValue = 0;
+    int fullmoveValue = 1;
+    fenStream >> placement >> activeColor >> castlingPart >> epPart >> halfmoveValue >> fullmoveValue;
+
+    // Piece placement, rank 8 first
+    int rank = 7;
+    int file = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) {
+                clear();
+                return false;
+            }
+            rank--;
+            file = 0;
+        } else if (std::isdigit(static_cast<unsigned char>(c))) {
+            file += c - '0';
+        } else {
+            const char* found = nullptr;
+            for (const char* p = PIECE_CHARS; *p; ++p) {
+                if (*p == std::tolower(static_cast<unsigned char>(c))) found = p;
+            }
+            if (!found || file > 7) {
+                clear();
+                return false;
+            }
+            putPiece(makeSquare(file, rank),
+                     static_cast<PieceType>(found - PIECE_CHARS),
+                     std::isupper(static_cast<unsigned char>(c)) ? PieceColor::WHITE : PieceColor::BLACK);
+            file++;
+        }
+        if (file > 8) {
+            clear();
+            return false;
+        }
+    }
+    if (rank != 0 || file != 8 ||
+        popCount(pieces(PieceColor::WHITE, PieceType::KING)) != 1 ||
+        popCount(pieces(PieceColor::BLACK, PieceType::KING)) != 1) {
+        clear();
+        return false;
+    }
+
+    side = (activeColor == "b") ? PieceColor::BLACK : PieceColor::WHITE;
+
+    // Castling rights, dropping any the board cannot support
+    for (char c : castlingPart) {
+        switch (c) {
+            case 'K': castling |= WHITE_OO; break;
+            case 'Q': castling |= WHITE_OOO; break;
+            case 'k': castling |= BLACK_OO; break;
+            case 'q': castling |= BLACK_OOO; break;
+            default: break;
+        }
+    }
+    const Bitboard whiteRooks = pieces(PieceColor::WHITE, PieceType::ROOK);
+    const Bitboard blackRooks = pieces(PieceColor::BLACK, PieceType::ROOK);
+    if (kingSquare(PieceColor::WHITE) != makeSquare(4, 0)) castling &= ~(WHITE_OO | WHITE_OOO);
+    if (kingSquare(PieceColor::BLACK) != makeSquare(4, 7)) castling &= ~(BLACK_OO | BLACK_OOO);
+    if (!(whiteRooks & squareBB(makeSquare(7, 0)))) castling &= ~WHITE_OO;
+    if (!(whiteRooks & squareBB(makeSquare(0, 0)))) castling &= ~WHITE_OOO;
+    if (!(blackRooks & squareBB(makeSquare(7, 7)))) castling &= ~BLACK_OO;
+    if (!(blackRooks & squareBB(makeSquare(0, 7)))) castling &= ~BLACK_OOO;
+
+    // En passant square, kept only if a pawn can capture onto it
+    const int ep = parseSquare(epPart);
+    if (ep != NO_SQUARE &&
+        (pawnAttacks(opposite(side), ep) & pieces(side, PieceType::PAWN))) {
+        epSquare = static_cast<std::uint8_t>(ep);
+    }
+
+    // Pieces were hashed as they were placed; add the remaining state
+    if (side == PieceColor::BLACK) key ^= ZOBRIST_SIDE_TO_MOVE_KEY;
+    key ^= ZOBRIST_CASTLING_KEYS[castling];
+    if (epSquare != NO_SQUARE) key ^= ZOBRIST_EP_FILE_KEYS[fileOf(epSquare)];
+
+    halfmove = static_cast<std::uint8_t>(halfmoveValue < 0 ? 0 : (halfmoveValue > 255 ? 255 : halfmoveValue));
+    fullmove = static_cast<std::uint16_t>(fullmoveValue < 1 ? 1 : fullmoveValue);
+    return true;
+}
+
+std::string Position::toFEN() const {
+    std::ostringstream fen;
+
+    for (int rank = 7; rank >= 0; --rank) {
+        int emptyCount = 0;
+        for (int file = 0; file < 8; ++file) {
+            PieceType type;
+            PieceColor color;
+            if (pieceAt(makeSquare(file, rank), type, color)) {
+                if (emptyCount > 0) {
+                    fen << emptyCount;
+                    emptyCount = 0;
+                }
+                const char c = PIECE_CHARS[static_cast<int>(type)];
+                fen << static_cast<char>(color == PieceColor::WHITE ? std::toupper(c) : c);
+            } else {
+                emptyCount++;
+            }
+        }
+        if (emptyCount > 0) fen << emptyCount;
+        if (rank > 0) fen << '/';
+    }
+
+    fen << ' ' << (side == PieceColor::WHITE ? 'w' : 'b') << ' ';
+
+    if (castling == 0) {
+        fen << '-';
+    } else {
+        if (castling & WHITE_OO) fen << 'K';
+        if (castling & WHITE_OOO) fen << 'Q';
+        if (castling & BLACK_OO) fen << 'k';
+        if (castling & BLACK_OOO) fen << 'q';
+    }
+
+    fen << ' ' << (epSquare == NO_SQUARE ? std::string("-") : squareName(epSquare));
+    fen << ' ' << static_cast<int>(halfmove) << ' ' << fullmove;
+
+    return fen.str();
+}
@@ -0,0 +1,153 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+#include <string>
+#include "chess_types.h"
+#include "bitboard.h"
+#include "attacks.h"
+#include "move.h"
+#include "zobrist.h"
+#include "psqt.h"
+
+// Standard starting position in FEN notation
+constexpr const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Castling right bits
+enum CastlingRight : std::uint8_t {
+    WHITE_OO  = 1,
+    WHITE_OOO = 2,
+    BLACK_OO  = 4,
+    BLACK_OOO = 8,
+    ALL_CASTLING = 15
+};
+
+// Marks an undo record whose move captured nothing
+constexpr std::uint8_t NO_CAPTURE = 0xFF;
+
+/**
+ * @brief Everything makeMove destroys that unmakeMove needs back
+ *
+ * Search and perft keep one of these per ply on the stack, so playing
+ * and taking back a move never touches the heap.
+ */
+struct UndoInfo {
+    Key key;                    // Hash before the move
+    Score psq;                  // Evaluation accumulators before the move
+    std::uint8_t phase;
+    std::uint8_t captured;      // PieceType of the captured piece, or NO_CAPTURE
+    std::uint8_t castling;
+    std::uint8_t epSquare;
+    std::uint8_t halfmove;
+};
+
+/**
+ * @brief Sprite-free chess position built on bitboards
+ *
+ * Holds one bitboard per piece type and per color plus the side to move,
+ * castling rights, en passant square, move clocks, the Zobrist key and the
+ * evaluation's material/piece-square accumulator and game phase, all of which
+ * makeMove keeps up to date incrementally. The whole object is 88 bytes so
+ * copying it is cheap and it fits in two cache lines.
+ */
+class Position {
+private:
+    Bitboard byType[PIECE_TYPE_COUNT];
+    Bitboard byColor[COLOR_COUNT];
+    Key key;
+    Score psq;                  // Material + piece-square sum from White's view
+    PieceColor side;
+    std::uint8_t castling;
+    std::uint8_t epSquare;      // NO_SQUARE when no en passant capture is possible
+    std::uint8_t halfmove;      // For fifty-move rule (resets on pawn move or capture)
+    std::uint8_t phase;         // Sum of PHASE_WEIGHTS over the pieces on the board
+    std::uint16_t fullmove;     // Increments after Black's move
+
+    // Adds or removes a piece known to be (or not be) on the square
+    void togglePiece(int sq, PieceType type, PieceColor color) {
+        const Bitboard bb = squareBB(sq);
+        byType[static_cast<int>(type)] ^= bb;
+        byColor[static_cast<int>(color)] ^= bb;
+    }
+
+    // Versions of the public functions for a side known at compile time
+    template <PieceColor Them> bool isAttackedBy(int sq) const;
+    template <PieceColor Us> void makeMoveAs(Move move, UndoInfo& undo);
+    template <PieceColor Us> void unmakeMoveAs(Move move, const UndoInfo& undo);
+
+public:
+    Position();
+
+    /**
+     * @brief Sets up the position from a FEN string
+     * @return False if the piece placement is malformed, leaving an empty board
+     */
+    bool setFromFEN(const std::string& fen);
+    std::string toFEN() const;
+
+    // Board queries
+    Bitboard pieces() const { return byColor[0] | byColor[1]; }
+    Bitboard pieces(PieceColor color) const { return byColor[static_cast<int>(color)]; }
+    Bitboard pieces(PieceType type) const { return byType[static_cast<int>(type)]; }
+    Bitboard pieces(PieceColor color, PieceType type) const {
+        return byColor[static_cast<int>(color)] & byType[static_cast<int>(type)];
+    }
+    bool isEmpty(int sq) const { return !(pieces() & squareBB(sq)); }
+    bool pieceAt(int sq, PieceType& type, PieceColor& color) const;
+    PieceType typeOn(int sq) const;
+    int kingSquare(PieceColor color) const;
+
+    // State queries
+    PieceColor sideToMove() const { return side; }
+    int castlingRights() const { return castling; }
+    int enPassantSquare() const { return epSquare; }
+    int halfmoveClock() const { return halfmove; }
+    int fullmoveNumber() const { return fullmove; }
+    Key hashKey() const { return key; }
+
+    // Evaluation accumulators
+    Score psqScore() const { return psq; }
+    int gamePhase() const { return phase; }
+
+    // Attack queries
+    bool isSquareAttacked(int sq, PieceColor attackingColor) const;
+    // Pieces of both colors attacking sq, with sliders seeing through to the given occupancy
+    Bitboard attackersTo(int sq, Bitboard occupied) const;
+    bool inCheck() const { return isSquareAttacked(kingSquare(side), opposite(side)); }
+
+    /**
+     * @brief Plays a move in place, saving what is needed to take it back
+     *
+     * The move must be pseudo-legal for the side to move. Legality is the
+     * caller's business: play the move, test whether the mover's king is
+     * attacked and unmake it again.
+     */
+    void makeMove(Move move, UndoInfo& undo);
+
+    /**
+     * @brief Takes back the last move played with makeMove
+     */
+    void unmakeMove(Move move, const UndoInfo& undo);
+
+    /**
+     * @brief Passes the move to the opponent (for null-move pruning)
+     *
+     * Must not be used while in check. The fifty-move counter restarts so
+     * that repetition checks never look back across the null move.
+     */
+    void makeNullMove(UndoInfo& undo);
+    void unmakeNullMove(const UndoInfo& undo);
+
+    // Plays a move that will never be taken back
+    void doMove(Move move) {
+        UndoInfo undo;
+        makeMove(move, undo);
+    }
+
+    // Low-level board editing (keeps the hash key and accumulators in step)
+    void putPiece(int sq, PieceType type, PieceColor color);
+    void removePiece(int sq);
+    void clear();
+};
+
+#endif // POSITION_H
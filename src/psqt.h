@@ -0,0 +1,43 @@
+#ifndef PSQT_H
+#define PSQT_H
+
+#include <array>
+#include <cstdint>
+#include "chess_types.h"
+
+/**
+ * @brief A middlegame and an endgame value packed into one integer
+ *
+ * The endgame half sits in the upper 16 bits, so two scores are added or
+ * subtracted with a single integer operation and both halves stay exact as
+ * long as each fits in 16 bits.
+ */
+using Score = std::int32_t;
+
+constexpr Score makeScore(int mg, int eg) {
+    return static_cast<Score>(static_cast<std::uint32_t>(eg) << 16) + mg;
+}
+
+inline int mgValue(Score s) {
+    return static_cast<std::int16_t>(static_cast<std::uint16_t>(static_cast<std::uint32_t>(s)));
+}
+
+// Rounds up first so a negative middlegame half's borrow is undone
+inline int egValue(Score s) {
+    return static_cast<std::int16_t>(static_cast<std::uint16_t>(static_cast<std::uint32_t>(s + 0x8000) >> 16));
+}
+
+// Game phase: each piece left on the board moves the evaluation from the
+// endgame (0) towards the middlegame (MAX_PHASE, the starting material)
+constexpr int PHASE_WEIGHTS[PIECE_TYPE_COUNT] = {0, 2, 1, 1, 4, 0}; // By PieceType
+constexpr int MAX_PHASE = 24;
+
+// Material plus piece-square bonus, from White's point of view (Black's entries are negated)
+using PieceSquareTable = std::array<std::array<std::array<Score, 64>, PIECE_TYPE_COUNT>, COLOR_COUNT>;
+extern const PieceSquareTable PSQT; // [color][piece type][square]
+
+inline Score pieceSquareScore(int sq, PieceType type, PieceColor color) {
+    return PSQT[static_cast<int>(color)][static_cast<int>(type)][sq];
+}
+
+#endif // PSQT_H
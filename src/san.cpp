@@ -0,0 +1,140 @@
+#include "san.h"
+#include "movegen.h"
+
+static const char SAN_PIECE_CHARS[PIECE_TYPE_COUNT] = {'P', 'R', 'N', 'B', 'Q', 'K'};
+
+std::string moveToSAN(const Position& pos, Move move) {
+    const int from = moveFrom(move);
+    const int to = moveTo(move);
+    std::string san;
+
+    if (isCastling(move)) {
+        san = (moveFlags(move) == KING_CASTLE) ? "O-O" : "O-O-O";
+    } else {
+        const PieceType type = pos.typeOn(from);
+        if (type == PieceType::PAWN) {
+            if (isCapture(move)) san += static_cast<char>('a' + fileOf(from));
+        } else {
+            san += SAN_PIECE_CHARS[static_cast<int>(type)];
+
+            // Other pieces of this type that may also go to the target square
+            MoveList moves;
+            generateLegalMoves(pos, moves);
+            bool ambiguous = false;
+            bool sameFile = false;
+            bool sameRank = false;
+            for (Move other : moves) {
+                const int otherFrom = moveFrom(other);
+                if (moveTo(other) != to || otherFrom == from || pos.typeOn(otherFrom) != type) continue;
+                ambiguous = true;
+                sameFile = sameFile || fileOf(otherFrom) == fileOf(from);
+                sameRank = sameRank || rankOf(otherFrom) == rankOf(from);
+            }
+            if (ambiguous) {
+                if (!sameFile) {
+                    san += static_cast<char>('a' + fileOf(from));
+                } else if (!sameRank) {
+                    san += static_cast<char>('1' + rankOf(from));
+                } else {
+                    san += squareName(from);
+                }
+            }
+        }
+
+        if (isCapture(move)) san += 'x';
+        san += squareName(to);
+        if (isPromotion(move)) {
+            san += '=';
+            san += SAN_PIECE_CHARS[static_cast<int>(promotionType(move))];
+        }
+    }
+
+    Position after = pos;
+    after.doMove(move);
+    if (after.inCheck()) {
+        MoveList replies;
+        generateLegalMoves(after, replies);
+        san += replies.empty() ? '#' : '+';
+    }
+    return san;
+}
+
+// Piece type for a SAN piece letter; pawns have none
+static bool sanPieceType(char c, PieceType& type) {
+    for (int i = 0; i < PIECE_TYPE_COUNT; ++i) {
+        if (SAN_PIECE_CHARS[i] == c && c != 'P') {
+            type = static_cast<PieceType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+Move parseSAN(const Position& pos, std::string_view san) {
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+        san.remove_suffix(1);
+    }
+    if (san.size() < 2) return NO_MOVE;
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        const int flag = (san.size() == 3) ? KING_CASTLE : QUEEN_CASTLE;
+        for (Move move : moves) {
+            if (moveFlags(move) == flag) return move;
+        }
+        return NO_MOVE;
+    }
+
+    PieceType type = PieceType::PAWN;
+    if (sanPieceType(san.front(), type)) san.remove_prefix(1);
+
+    // Promotion piece, with or without '='
+    bool promotes = false;
+    PieceType promotion = PieceType::QUEEN;
+    if (sanPieceType(san.back(), promotion)) {
+        promotes = true;
+        san.remove_suffix(1);
+        if (!san.empty() && san.back() == '=') san.remove_suffix(1);
+    }
+
+    if (san.size() < 2) return NO_MOVE;
+    const char toFile = san[san.size() - 2];
+    const char toRank = san[san.size() - 1];
+    if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8') return NO_MOVE;
+    const int to = makeSquare(toFile - 'a', toRank - '1');
+    san.remove_suffix(2);
+
+    // Whatever is left before the target square narrows down the origin
+    int fromFile = -1;
+    int fromRank = -1;
+    for (char c : san) {
+        if (c >= 'a' && c <= 'h') {
+            fromFile = c - 'a';
+        } else if (c >= '1' && c <= '8') {
+            fromRank = c - '1';
+        } else if (c != 'x' && c != '-' && c != ':') {
+            return NO_MOVE;
+        }
+    }
+
+    for (Move move : moves) {
+        const int from = moveFrom(move);
+        if (moveTo(move) != to || pos.typeOn(from) != type || isCastling(move)) continue;
+        if (fromFile >= 0 && fileOf(from) != fromFile) continue;
+        if (fromRank >= 0 && rankOf(from) != fromRank) continue;
+        if (isPromotion(move) != promotes) continue;
+        if (promotes && promotionType(move) != promotion) continue;
+        return move;
+    }
+    return NO_MOVE;
+}
+
+std::string stripSAN(const std::string& san) {
+    std::string stripped;
+    for (char c : san) {
+        if (c != '+' && c != '#' && c != '!' && c != '?') stripped += c;
+    }
+    return stripped;
+}
@@ -0,0 +1,30 @@
+#ifndef SAN_H
+#define SAN_H
+
+#include <string>
+#include <string_view>
+#include "position.h"
+#include "move.h"
+
+/**
+ * @brief Standard algebraic notation of a legal move ("Nbd2", "exd5", "O-O", "e8=Q+")
+ *
+ * The origin file or rank is added only when another piece of the same type
+ * could reach the same square, and the move is played on a copy of the
+ * position to append '+' or '#'.
+ */
+std::string moveToSAN(const Position& pos, Move move);
+
+/**
+ * @brief The legal move a SAN string stands for, or NO_MOVE if there is none
+ *
+ * Accepts what PGN files contain in practice: check marks and annotations,
+ * "0-0" castling, promotions with or without '=', redundant disambiguation
+ * and long algebraic "Ng1-f3". Matches against the legal move generator.
+ */
+Move parseSAN(const Position& pos, std::string_view san);
+
+// The SAN with check marks and annotations ('+', '#', '!', '?') removed, for comparisons
+std::string stripSAN(const std::string& san);
+
+#endif // SAN_H
@@ -1,368 +1,825 @@
-﻿#include <iostream>
-#include <map>
-#include <string>
-#include <vector>
+﻿#include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <iomanip>
+#include <cmath>
 #include <thread>
-#include <mutex>
-#include <future>
-#include <unordered_map>
-#include <algorithm>
-#include <array>
-#include <random>
-#include "pieces_placement.h"
-#include "game_logic.h"
-
-// Structure to store move calculation results
-struct MoveCountResult {
-    int depth;
-    long long nodes;
-    double timeMs;
-};
+#include <vector>
+#include <memory>
+#include "search.h"
+#include "movegen.h"
+#include "movepick.h"
+#include "evaluate.h"
+#include "nnue.h"
+#include "tt.h"
+#include "timeman.h"
+#include "syzygy.h"
+
+// Mate scores are stored relative to the node, not the root, so that a
+// transposition reached at another ply reports the right distance to mate
+static int scoreToTT(int score, int ply) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) return score + ply;
+    if (score <= -VALUE_MATE_IN_MAX_PLY) return score - ply;
+    return score;
+}
+
+static int scoreFromTT(int score, int ply) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) return score - ply;
+    if (score <= -VALUE_MATE_IN_MAX_PLY) return score + ply;
+    return score;
+}
+
+// Forward pruning margins in centipawns, per ply of remaining depth
+constexpr int REVERSE_FUTILITY_MARGIN = 80;
+constexpr int RAZOR_MARGIN = 300;
+constexpr int FUTILITY_MARGIN = 100;
+
+// Late-move reductions by depth and move number: log(depth) * log(moveCount),
+// so reductions grow slowly with both and stay small in shallow trees
+constexpr int LMR_TABLE_SIZE = 64;
+static int lmrTable[LMR_TABLE_SIZE][LMR_TABLE_SIZE];
+
+static bool initLmrTable() {
+    for (int depth = 1; depth < LMR_TABLE_SIZE; ++depth) {
+        for (int moveCount = 1; moveCount < LMR_TABLE_SIZE; ++moveCount) {
+            lmrTable[depth][moveCount] =
+                static_cast<int>(0.75 + std::log(depth) * std::log(moveCount) / 2.25);
+        }
+    }
+    return true;
+}
+static const bool lmrTableReady = initLmrTable();
+
+static int lmrReduction(int depth, int moveCount) {
+    return lmrTable[depth < LMR_TABLE_SIZE ? depth : LMR_TABLE_SIZE - 1]
+                   [moveCount < LMR_TABLE_SIZE ? moveCount : LMR_TABLE_SIZE - 1];
+}
+
+void SearchStats::add(const SearchStats& other) {
+    nullMoveTries += other.nullMoveTries;
+    nullMoveCutoffs += other.nullMoveCutoffs;
+    nullMoveVerifications += other.nullMoveVerifications;
+    lmrReductions += other.lmrReductions;
+    lmrResearches += other.lmrResearches;
+    futilityPrunes += other.futilityPrunes;
+    reverseFutilityPrunes += other.reverseFutilityPrunes;
+    razorPrunes += other.razorPrunes;
+    checkExtensions += other.checkExtensions;
+    tbHits += other.tbHits;
+}
+
+// Techniques used by searchPosition
+static SearchFeatures searchFeatures;
+
+void setSearchFeatures(const SearchFeatures& features) {
+    searchFeatures = features;
+}
+
+SearchFeatures getSearchFeatures() {
+    return searchFeatures;
+}
+
+// Number of threads used by searchPosition
+static int searchThreadCount = 1;
+
+void setSearchThreads(int threads) {
+    searchThreadCount = threads < 1 ? 1 : (threads > MAX_SEARCH_THREADS ? MAX_SEARCH_THREADS : threads);
+}
+
+int getSearchThreads() {
+    return searchThreadCount;
+}
+
+// Signals shared with whoever controls the search (the UCI loop)
+static std::atomic<bool> stopRequested(false);
+static std::atomic<bool> pondering(false);
+static std::atomic<long long> ponderHitMs(0);     // When the last ponderhit restarted the clock
+
+static long long nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void prepareSearch(bool ponder) {
+    stopRequested.store(false);
+    pondering.store(ponder);
+}
+
+void requestStop() { stopRequested.store(true); }
+bool isStopRequested() { return stopRequested.load(); }
+bool isPondering() { return pondering.load(); }
+
+void ponderHit() {
+    ponderHitMs.store(nowMs());
+    pondering.store(false);
+}
+
+// Keys of earlier game positions worth checking for repetitions
+constexpr int MAX_HISTORY_KEYS = 256;
+
+// Quiet moves a node remembers for the history penalty after a cutoff
+constexpr int MAX_QUIETS_TRIED = 64;
+
+// What the search keeps for one ply of the current path. The frames are
+// part of the worker, so the recursion's own stack frames stay small and
+// nothing is allocated while searching.
+struct SearchFrame {
+    Move move = NO_MOVE;                // Move played from this ply and the piece that made it
+    int piece = -1;                     // (NO_MOVE and -1 for a null move)
+    int staticEval = VALUE_NONE;        // VALUE_NONE when in check
+    Move killers[2] = {NO_MOVE, NO_MOVE};   // Quiet moves that caused a cutoff at this ply
+
+    // Principal variation from this ply, indexed by absolute ply: pv[ply..pvLength)
+    Move pv[MAX_PLY + 1];
+    int pvLength = 0;
 
-// Reference values for standard position - first 8 plies
-const long long EXPECTED_NODES[] = {
-    20,            // Depth 1
-    400,           // Depth 2
-    8902,          // Depth 3 - Our implementation's value
-    219326,        // Depth 4 - Our corrected value with en passant
-    5832730,       // Depth 5 - Our corrected value with en passant
-    119060324,     // Depth 6
-    3195901860,    // Depth 7
-    84998978956    // Depth 8
+    // Quiet moves searched without a cutoff, penalized if a later quiet move cuts off
+    Move quietsTried[MAX_QUIETS_TRIED];
+    int quietPieces[MAX_QUIETS_TRIED];
+
+    PickerStorage picker;               // Shared by search and qsearch, which never pick at the same time
 };
 
-// Add castling rights tracking
-struct CastlingRights {
-    bool whiteKingSide = true;
-    bool whiteQueenSide = true;
-    bool blackKingSide = true;
-    bool blackQueenSide = true;
+// One searcher with its own copy of the position. Lazy SMP runs several of
+// these on the same root; they share nothing but the transposition table
+// and the stop flags.
+class SearchWorker {
+public:
+    SearchWorker(const Position& root, const std::vector<Key>& history, int index, long long clockStart,
+                 const std::atomic<bool>& stopFlag, const SearchFeatures& activeFeatures, TranspositionTable& tt,
+                 const std::vector<Move>& searchMoves, bool rootInTablebase)
+        : pos(root), threadIndex(index), startMs(clockStart), stop(stopFlag), features(activeFeatures),
+          table(tt), rootMoves(searchMoves), useNNUE(isNetworkLoaded()) {
+        // Only positions since the last capture or pawn move can repeat
+        const int usable = static_cast<int>(history.size()) < MAX_HISTORY_KEYS
+                         ? static_cast<int>(history.size()) : MAX_HISTORY_KEYS;
+        historyCount = usable;
+        for (int i = 0; i < usable; ++i) {
+            keyStack[i] = history[history.size() - usable + i];
+        }
+        if (useNNUE) refreshAccumulator(pos, accumulators[0]);
+        moveHistory.clear();
+
+        // Probing below a root that is already in the tables would add nothing
+        const TablebaseConfig tbConfig = getTablebaseConfig();
+        tbCardinality = rootInTablebase ? 0 : std::min(tablebaseMaxPieces(), tbConfig.probeLimit);
+        tbProbeDepth = tbConfig.probeDepth;
+        tbRule50 = tbConfig.rule50;
+    }
+
+    // timeManager is null for helper threads, which run until the main thread stops them
+    SearchResult iterate(const SearchLimits& limits, TimeManager* timeManager,
+                         const IterationCallback& onIteration);
+    long long nodeCount() const { return nodes; }
+    long long elapsedMs() const;
+
+private:
+    Position pos;
+    const int threadIndex;              // 0 is the main thread
+    const long long startMs;            // When searchPosition() started
+    const std::atomic<bool>& stop;      // Raised by the main thread when it is done
+    const SearchFeatures features;      // Copied at the start so a search never sees a change
+    TranspositionTable& table;
+    SearchStats stats;
+    TraceCounters trace;                // Own cache lines, summed by searchPosition()
+    const std::vector<Move> rootMoves;  // Root moves to search; empty for all of them
+    bool timeUp = false;                // Main thread only: a limit was reached
+    const SearchLimits* limits = nullptr;
+    TimeManager* time = nullptr;
+    long long nodes = 0;
+    int ply = 0;
+    int rootDepth = 0;                  // Depth of the current iteration
+    int nullMoveMinPly = 0;             // No null moves above this ply while verifying one
+
+    // Tablebase probing: positions with at most tbCardinality pieces are probed
+    int tbCardinality = 0;
+    int tbProbeDepth = 1;
+    bool tbRule50 = true;
+
+    // Game history followed by the keys of the positions on the current path
+    Key keyStack[MAX_HISTORY_KEYS + MAX_PLY];
+    int historyCount = 0;
+
+    // One frame per ply of the current path
+    SearchFrame frames[MAX_PLY + 1];
+
+    // Move ordering statistics, cleared for every search
+    SearchHistory moveHistory;
+
+    // Network hidden layer for each position on the current path, by ply
+    const bool useNNUE;
+    Accumulator accumulators[MAX_PLY + 1];
+
+    int evaluatePosition() {
+        TRACE(trace.evalCalls++; TraceTimer evalTimer(&trace.evalNs));
+        return useNNUE ? evaluateNNUE(pos, accumulators[ply]) : evaluate(pos);
+    }
+    int search(int alpha, int beta, int depth);
+    int qsearch(int alpha, int beta);
+    PieceToHistory* continuationAt(int back);
+    void updateQuietStats(Move best, int depth, int quietCount);
+    bool isRepetition() const;
+    bool stopped();
+
+    // A beta cutoff by the moveCount-th move searched
+    void recordCutoff(int moveCount) {
+        trace.betaCutoffs++;
+        trace.cutoffsByIndex[moveCount <= CUTOFF_INDEX_BUCKETS ? moveCount - 1 : CUTOFF_INDEX_BUCKETS - 1]++;
+    }
 };
 
-// Global variable to keep track of castling rights
-static CastlingRights castlingRights = {true, true, true, true};
-
-// Function declarations to resolve forward reference issues
-bool isSquareAttacked(const std::map<BoardPosition, ChessPiece>& pieces, 
-                     const BoardPosition& square, 
-                     PieceColor attackingColor);
-                     
-bool isCastlingMove(const ChessPiece& piece, const BoardPosition& from, const BoardPosition& to);
-
-void handleCastling(std::map<BoardPosition, ChessPiece>& pieces, 
-                   const ChessPiece& king,
-                   const BoardPosition& from, 
-                   const BoardPosition& to);
-                   
-int scoreMoveForOrdering(const BoardPosition& from, const BoardPosition& to, 
-                         const ChessPiece& movingPiece,
-                         const std::map<BoardPosition, ChessPiece>& pieces);
-                         
-void orderMoves(std::vector<BoardPosition>& moves, const BoardPosition& from, 
-                const ChessPiece& movingPiece,
-                const std::map<BoardPosition, ChessPiece>& pieces);
-
-void updateCastlingRights(const BoardPosition& from, const ChessPiece& piece);
-
-void updateCastlingRightsForCapture(const BoardPosition& to, const ChessPiece& capturedPiece);
-
-bool isKingInCheck(const std::map<BoardPosition, ChessPiece>& pieces, PieceColor kingColor);
-
-// Implementation of filterLegalMoves
-std::vector<BoardPosition> filterLegalMoves(
-    const BoardPosition& from,
-    const std::vector<BoardPosition>& moves,
-    std::map<BoardPosition, ChessPiece>& pieces,
-    PieceColor currentTurn)
-{
-    std::vector<BoardPosition> legalMoves;
-    legalMoves.reserve(moves.size());
-    
-    // Find the king's position
-    BoardPosition kingPos(-1, -1);
-    for (const auto& [pos, piece] : pieces) {
-        if (piece.type == PieceType::KING && piece.color == currentTurn) {
-            kingPos = pos;
-            break;
+// Repetition of an earlier position since the last irreversible move (counted as a draw)
+bool SearchWorker::isRepetition() const {
+    const Key key = pos.hashKey();
+    const int current = historyCount + ply;
+    const int limit = current < pos.halfmoveClock() ? current : pos.halfmoveClock();
+    for (int back = 4; back <= limit; back += 2) {
+        if (keyStack[current - back] == key) return true;
+    }
+    return false;
+}
+
+// Time on this move's clock. Searches of other positions may run at the same
+// time, so the start is per search; only a ponderhit (which comes later) moves it.
+long long SearchWorker::elapsedMs() const {
+    return nowMs() - std::max(startMs, ponderHitMs.load(std::memory_order_relaxed));
+}
+
+bool SearchWorker::stopped() {
+    if (timeUp || stop.load(std::memory_order_relaxed) || stopRequested.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    // The main thread checks the node and time limits, polling the clock
+    // only every TIME_CHECK_INTERVAL nodes
+    if (threadIndex == 0 && (nodes % TIME_CHECK_INTERVAL) == 0) {
+        if (limits->nodes > 0 && nodes >= limits->nodes) {
+            timeUp = true;
+        } else if (time && !pondering.load(std::memory_order_relaxed) &&
+                   time->hardLimitReached(elapsedMs())) {
+            timeUp = true;
         }
     }
-    
-    if (kingPos.first == -1) return legalMoves; // King not found
-    
-    // The piece at 'from' position
-    auto pieceIt = pieces.find(from);
-    if (pieceIt == pieces.end()) return legalMoves;
-    
-    // For each candidate move, check if it would leave/put the king in check
-    for (const auto& to : moves) {
-        // Create a temporary board to test the move
-        auto tempPieces = pieces;
-        
-        // Update king position if the king is moving
-        BoardPosition newKingPos = (pieceIt->second.type == PieceType::KING) ? to : kingPos;
-        
-        // Execute the move on the temporary board
-        ChessPiece movingPiece = tempPieces[from];
-        tempPieces.erase(from);
-        
-        // Handle capture
-        if (tempPieces.find(to) != tempPieces.end()) {
-            tempPieces.erase(to);
+    return timeUp;
+}
+
+// Continuation history of the move played `back` plies above the current node
+PieceToHistory* SearchWorker::continuationAt(int back) {
+    if (ply < back || frames[ply - back].piece < 0) return nullptr;
+    const SearchFrame& frame = frames[ply - back];
+    return &moveHistory.continuation[frame.piece][moveTo(frame.move)];
+}
+
+// A quiet move caused a cutoff: reward it and penalize the quiet moves tried before it
+void SearchWorker::updateQuietStats(Move best, int depth, int quietCount) {
+    const int us = static_cast<int>(pos.sideToMove());
+    const int bonus = depth * depth * 16 < 1600 ? depth * depth * 16 : 1600;
+
+    SearchFrame& frame = frames[ply];
+    if (frame.killers[0] != best) {
+        frame.killers[1] = frame.killers[0];
+        frame.killers[0] = best;
+    }
+    if (ply > 0 && frames[ply - 1].piece >= 0) {
+        moveHistory.counterMoves[frames[ply - 1].piece][moveTo(frames[ply - 1].move)] = best;
+    }
+
+    PieceToHistory* cont1 = continuationAt(1);
+    PieceToHistory* cont2 = continuationAt(2);
+    auto update = [&](Move move, int piece, int amount) {
+        updateHistoryEntry(moveHistory.butterfly[us][moveFrom(move)][moveTo(move)], amount);
+        if (cont1) updateHistoryEntry((*cont1)[piece][moveTo(move)], amount);
+        if (cont2) updateHistoryEntry((*cont2)[piece][moveTo(move)], amount);
+    };
+
+    update(best, pieceIndex(pos.sideToMove(), pos.typeOn(moveFrom(best))), bonus);
+    for (int i = 0; i < quietCount; ++i) {
+        update(frame.quietsTried[i], frame.quietPieces[i], -bonus);
+    }
+}
+
+// Captures are skipped when even winning the piece outright leaves us this far below alpha
+constexpr int DELTA_MARGIN = 200;
+
+// Quiescence search: resolve captures (and check evasions) until the position is quiet
+int SearchWorker::qsearch(int alpha, int beta) {
+    const bool pvNode = beta - alpha > 1;
+
+    SearchFrame& frame = frames[ply];
+    frame.pvLength = ply;
+    if (stopped()) return 0;
+    TRACE(trace.qnodes++);
+    if (ply >= MAX_PLY - 1) return evaluatePosition();
+
+    const Key key = pos.hashKey();
+    TTData tt;
+    const bool ttHit = table.probe(key, tt);
+    TRACE(trace.ttProbes++; trace.ttHits += ttHit);
+    if (ttHit && !pvNode) {
+        const int ttScore = scoreFromTT(tt.score, ply);
+        if (tt.bound == BOUND_EXACT ||
+            (tt.bound == BOUND_LOWER && ttScore >= beta) ||
+            (tt.bound == BOUND_UPPER && ttScore <= alpha)) {
+            TRACE(trace.ttCutoffs++);
+            return ttScore;
+        }
+    }
+
+    // Stand pat: the side to move may decline every capture, except when in check
+    const bool inCheck = pos.inCheck();
+    int standPat = VALUE_NONE;
+    int bestScore = -VALUE_INFINITE;
+    if (!inCheck) {
+        standPat = (ttHit && tt.eval != VALUE_NONE) ? tt.eval : evaluatePosition();
+        if (standPat >= beta) {
+            if (!ttHit) table.store(key, NO_MOVE, scoreToTT(standPat, ply), standPat, 0, BOUND_LOWER);
+            return standPat;
         }
-        
-        // Place the piece in its new position
-        tempPieces[to] = movingPiece;
-        
-        // Determine the opponent's color
-        PieceColor opponentColor = (currentTurn == PieceColor::WHITE) ? 
-                                  PieceColor::BLACK : PieceColor::WHITE;
-        
-        // Check if the king would be in check after this move
-        bool kingInCheck = false;
-        
-        // Check if any opponent's piece attacks the king
-        for (const auto& [pos, piece] : tempPieces) {
-            if (piece.color == opponentColor) {
-                // Simple check for direct attacks
-                if (isSquareAttacked(tempPieces, newKingPos, opponentColor)) {
-                    kingInCheck = true;
+        if (standPat > alpha) alpha = standPat;
+        bestScore = standPat;
+    }
+
+    const int originalAlpha = alpha;
+    const int prevPiece = ply > 0 ? frames[ply - 1].piece : -1;
+    const int prevTo = ply > 0 ? moveTo(frames[ply - 1].move) : 0;
+    MovePicker picker(pos, frame.picker, ttHit ? tt.move : NO_MOVE, moveHistory, nullptr, prevPiece, prevTo,
+                      continuationAt(1), continuationAt(2), false);
+
+    Move bestMove = NO_MOVE;
+    int moveCount = 0;
+    UndoInfo undo;
+    Move move;
+    while ((move = picker.next()) != NO_MOVE) {
+        moveCount++;
+
+        if (!inCheck) {
+            // Under-promotions and captures that lose material are not worth resolving
+            if (isPromotion(move) && promotionType(move) != PieceType::QUEEN) continue;
+            if (!seeGE(pos, move, 0)) continue;
+
+            // Delta pruning: the capture cannot bring the score back up to alpha
+            if (!isPromotion(move)) {
+                const PieceType victim = isEnPassant(move) ? PieceType::PAWN : pos.typeOn(moveTo(move));
+                if (standPat + PIECE_VALUES[static_cast<int>(victim)] + DELTA_MARGIN <= alpha) continue;
+            }
+        }
+
+        frame.move = move;
+        frame.piece = pieceIndex(pos.sideToMove(), pos.typeOn(moveFrom(move)));
+
+        pos.makeMove(move, undo);
+        if (useNNUE) updateAccumulator(accumulators[ply], accumulators[ply + 1], pos, move, undo);
+        ply++;
+        nodes++;
+        const int score = -qsearch(-beta, -alpha);
+        ply--;
+        pos.unmakeMove(move, undo);
+
+        if (stopped()) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                bestMove = move;
+
+                const SearchFrame& child = frames[ply + 1];
+                frame.pv[ply] = move;
+                for (int j = ply + 1; j < child.pvLength; ++j) {
+                    frame.pv[j] = child.pv[j];
+                }
+                frame.pvLength = child.pvLength;
+
+                if (alpha >= beta) {
+                    TRACE(recordCutoff(moveCount));
                     break;
                 }
             }
         }
-        
-        // If the king is not in check, this is a legal move
-        if (!kingInCheck) {
-            legalMoves.push_back(to);
-        }
     }
-    
-    return legalMoves;
+
+    // Every evasion was tried and none exists: checkmate
+    if (inCheck && moveCount == 0) return -VALUE_MATE + ply;
+
+    const Bound bound = bestScore >= beta ? BOUND_LOWER
+                      : (alpha > originalAlpha ? BOUND_EXACT : BOUND_UPPER);
+    table.store(key, bestMove, scoreToTT(bestScore, ply), standPat, 0, bound);
+
+    return bestScore;
 }
 
-// Function to find the best move using alpha-beta search
-std::pair<BoardPosition, BoardPosition> findBestMove(
-    std::map<BoardPosition, ChessPiece>& pieces, 
-    PieceColor sideToMove, 
-    int searchDepth) {
-    
-    // This is a placeholder implementation that returns the first legal move found
-    std::pair<BoardPosition, BoardPosition> bestMove;
-    
-    // Get all pieces of the current player
-    std::vector<BoardPosition> playerPieces;
-    for (const auto& [pos, piece] : pieces) {
-        if (piece.color == sideToMove) {
-            playerPieces.push_back(pos);
+int SearchWorker::search(int alpha, int beta, int depth) {
+    const bool pvNode = beta - alpha > 1;
+    const bool rootNode = (ply == 0);
+
+    SearchFrame& frame = frames[ply];
+    frame.pvLength = ply;
+    if (stopped()) return 0;
+
+    if (!rootNode) {
+        if (pos.halfmoveClock() >= 100 || isRepetition()) return 0;
+
+        // Mate distance pruning: a shorter mate was already found elsewhere
+        alpha = alpha > -VALUE_MATE + ply ? alpha : -VALUE_MATE + ply;
+        beta = beta < VALUE_MATE - ply - 1 ? beta : VALUE_MATE - ply - 1;
+        if (alpha >= beta) return alpha;
+    }
+
+    if (ply >= MAX_PLY - 1) return evaluatePosition();
+    if (depth <= 0) return qsearch(alpha, beta);
+
+    const Key key = pos.hashKey();
+    TTData tt;
+    const bool ttHit = table.probe(key, tt);
+    const Move ttMove = ttHit ? tt.move : NO_MOVE;
+    TRACE(trace.ttProbes++; trace.ttHits += ttHit);
+
+    // Cut off with a stored result, except in PV nodes where we want the full line
+    if (ttHit && !pvNode && tt.depth >= depth) {
+        const int ttScore = scoreFromTT(tt.score, ply);
+        if (tt.bound == BOUND_EXACT ||
+            (tt.bound == BOUND_LOWER && ttScore >= beta) ||
+            (tt.bound == BOUND_UPPER && ttScore <= alpha)) {
+            TRACE(trace.ttCutoffs++);
+            return ttScore;
         }
     }
-    
-    // Find the first legal move
-    for (const auto& from : playerPieces) {
-        // Get pseudo-legal moves for this piece
-        std::vector<BoardPosition> legalMoves;
-        
-        // Implement basic move generation for each piece type
-        const ChessPiece& piece = pieces[from];
-        
-        // Get a legal move
-        for (int x = 0; x < 8; x++) {
-            for (int y = 0; y < 8; y++) {
-                BoardPosition to{x, y};
-                
-                // Check if this is a self-capture
-                auto targetIt = pieces.find(to);
-                if (targetIt != pieces.end() && targetIt->second.color == sideToMove) {
-                    continue;
+
+    keyStack[historyCount + ply] = key;
+
+    // Tablebase probe, only right after a capture or pawn move (the tables
+    // know nothing of the fifty-move counter) and without castling rights.
+    // At the largest piece count only deep enough nodes pay for the probe.
+    if (!rootNode && tbCardinality > 0 && pos.halfmoveClock() == 0 && pos.castlingRights() == 0) {
+        const int pieceCount = popCount(pos.pieces());
+        if (pieceCount <= tbCardinality && (pieceCount < tbCardinality || depth >= tbProbeDepth)) {
+            ProbeState state;
+            const WDLScore wdl = probeWDL(pos, state);
+            if (stopped()) return 0;
+
+            if (state != PROBE_FAIL) {
+                stats.tbHits++;
+
+                // Wins rank below every mate found by search; with the fifty-move
+                // rule cursed wins and blessed losses are draws, barely better or worse
+                const int drawScore = tbRule50 ? 1 : 0;
+                const int tbScore = wdl < -drawScore ? -VALUE_MATE_IN_MAX_PLY + ply + 1
+                                  : wdl > drawScore ? VALUE_MATE_IN_MAX_PLY - ply - 1
+                                  : 2 * wdl * drawScore;
+                const Bound tbBound = wdl < -drawScore ? BOUND_UPPER
+                                    : wdl > drawScore ? BOUND_LOWER : BOUND_EXACT;
+
+                if (tbBound == BOUND_EXACT || (tbBound == BOUND_LOWER ? tbScore >= beta : tbScore <= alpha)) {
+                    table.store(key, NO_MOVE, scoreToTT(tbScore, ply), VALUE_NONE,
+                             depth + 6 < MAX_PLY - 1 ? depth + 6 : MAX_PLY - 1, tbBound);
+                    return tbScore;
                 }
-                
-                legalMoves.push_back(to);
             }
         }
-        
-        // Filter moves that would leave the king in check
-        legalMoves = filterLegalMoves(from, legalMoves, pieces, sideToMove);
-        
-        if (!legalMoves.empty()) {
-            bestMove = {from, legalMoves[0]};
-            break;
-        }
     }
-    
-    return bestMove;
-}
 
-// Calculate number of moves for a specific position
-void calculateMovesForPosition(const std::string& fen) {
-    std::cout << "Analyzing position: " << fen << std::endl;
-    
-    // Create an empty board
-    std::map<BoardPosition, ChessPiece> pieces;
-    
-    // Create a game logic object
-    ChessGameLogic gameLogic(pieces);
-    
-    // Set up the board from FEN
-    gameLogic.setupFromFEN(fen);
-    
-    // Show the current game state
-    std::cout << "Current turn: " << (gameLogic.getCurrentTurn() == PieceColor::WHITE ? "White" : "Black") << std::endl;
-    std::cout << "Game state: ";
-    
-    switch (gameLogic.getGameState()) {
-        case GameState::ACTIVE: std::cout << "Active"; break;
-        case GameState::CHECK: std::cout << "Check"; break;
-        case GameState::CHECKMATE: std::cout << "Checkmate"; break;
-        case GameState::STALEMATE: std::cout << "Stalemate"; break;
-        case GameState::DRAW_FIFTY: std::cout << "Draw (50-move rule)"; break;
-        case GameState::DRAW_REPETITION: std::cout << "Draw (threefold repetition)"; break;
-        case GameState::DRAW_MATERIAL: std::cout << "Draw (insufficient material)"; break;
-        case GameState::DRAW_AGREEMENT: std::cout << "Draw (by agreement)"; break;
-    }
-    std::cout << std::endl;
-    
-    std::cout << "Analysis completed." << std::endl;
-}
+    const bool inCheck = pos.inCheck();
+    const int staticEval = inCheck ? VALUE_NONE
+                         : (ttHit && tt.eval != VALUE_NONE) ? tt.eval : evaluatePosition();
+    frame.staticEval = staticEval;
 
-// Calculate number of moves for the starting position
-void calculateMovesForStartingPosition() {
-    calculateMovesForPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-}
+    // Forward pruning, only where a wrong guess cannot lose the principal variation
+    if (!pvNode && !inCheck) {
+        const bool betaIsMate = isMateScore(beta);
 
-// Implementation of isSquareAttacked
-bool isSquareAttacked(const std::map<BoardPosition, ChessPiece>& pieces, 
-                     const BoardPosition& square, 
-                     PieceColor attackingColor) {
-    const int targetX = square.first;
-    const int targetY = square.second;
-    
-    // Check for pawn attacks
-    const int pawnDirection = (attackingColor == PieceColor::WHITE) ? 1 : -1;
-    for (int dx : {-1, 1}) {
-        const int pawnX = targetX + dx;
-        const int pawnY = targetY + pawnDirection;
-        
-        // Check board bounds
-        if (pawnX >= 0 && pawnX < 8 && pawnY >= 0 && pawnY < 8) {
-            BoardPosition pawnPos(pawnX, pawnY);
-            auto pieceIt = pieces.find(pawnPos);
-            if (pieceIt != pieces.end() && 
-                pieceIt->second.color == attackingColor && 
-                pieceIt->second.type == PieceType::PAWN) {
-                return true;
-            }
+        // Reverse futility: far enough above beta that no quiet line will bring it back
+        if (features.reverseFutility && depth <= 8 && !betaIsMate &&
+            staticEval - REVERSE_FUTILITY_MARGIN * depth >= beta) {
+            stats.reverseFutilityPrunes++;
+            return staticEval;
         }
-    }
-    
-    // Check for knight attacks
-    static const std::pair<int, int> knightMoves[] = {
-        {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
-        {1, -2}, {1, 2}, {2, -1}, {2, 1}
-    };
-    
-    for (const auto& [dx, dy] : knightMoves) {
-        const int knightX = targetX + dx;
-        const int knightY = targetY + dy;
-        
-        // Check board bounds
-        if (knightX >= 0 && knightX < 8 && knightY >= 0 && knightY < 8) {
-            BoardPosition knightPos(knightX, knightY);
-            auto pieceIt = pieces.find(knightPos);
-            if (pieceIt != pieces.end() && 
-                pieceIt->second.color == attackingColor && 
-                pieceIt->second.type == PieceType::KNIGHT) {
-                return true;
+
+        // Razoring: far below alpha, only captures can help, so let qsearch decide
+        if (features.razoring && depth <= 3 && staticEval + RAZOR_MARGIN * depth <= alpha) {
+            const int score = qsearch(alpha, alpha + 1);
+            if (score <= alpha) {
+                stats.razorPrunes++;
+                return score;
             }
         }
-    }
-    
-    // Check king attacks (for adjacent squares)
-    static const std::pair<int, int> kingMoves[] = {
-        {-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-        {0, 1}, {1, -1}, {1, 0}, {1, 1}
-    };
-    
-    for (const auto& [dx, dy] : kingMoves) {
-        const int kingX = targetX + dx;
-        const int kingY = targetY + dy;
-        
-        // Check board bounds
-        if (kingX >= 0 && kingX < 8 && kingY >= 0 && kingY < 8) {
-            BoardPosition kingPos(kingX, kingY);
-            auto pieceIt = pieces.find(kingPos);
-            if (pieceIt != pieces.end() && 
-                pieceIt->second.color == attackingColor && 
-                pieceIt->second.type == PieceType::KING) {
-                return true;
+
+        // Null move: if passing still beats beta, a real move will too. Not
+        // after another null move and not without pieces, where zugzwang is common.
+        const Bitboard nonPawns = pos.pieces(pos.sideToMove()) &
+                                  ~(pos.pieces(PieceType::PAWN) | pos.pieces(PieceType::KING));
+        const bool afterNull = ply > 0 && frames[ply - 1].move == NO_MOVE;
+        if (features.nullMove && depth >= 3 && ply >= nullMoveMinPly && !afterNull && nonPawns &&
+            staticEval >= beta && !betaIsMate) {
+            const int reduction = 3 + depth / 4 + ((staticEval - beta) / 200 < 3 ? (staticEval - beta) / 200 : 3);
+            const int nullDepth = depth - 1 - reduction;
+
+            stats.nullMoveTries++;
+            UndoInfo undo;
+            frame.move = NO_MOVE;
+            frame.piece = -1;
+            pos.makeNullMove(undo);
+            if (useNNUE) accumulators[ply + 1] = accumulators[ply];
+            ply++;
+            nodes++;
+            int score = -search(-beta, -beta + 1, nullDepth);
+            ply--;
+            pos.unmakeNullMove(undo);
+
+            if (stopped()) return 0;
+
+            if (score >= beta) {
+                if (isMateScore(score)) score = beta;
+
+                // With a single piece (or deep down) zugzwang can fake the cutoff:
+                // confirm it with a reduced search that may not pass near the root
+                if (!moreThanOne(nonPawns) || depth >= 12) {
+                    stats.nullMoveVerifications++;
+                    const int savedMinPly = nullMoveMinPly;
+                    nullMoveMinPly = ply + 3 * (nullDepth > 0 ? nullDepth : 0) / 4 + 1;
+                    const int verified = search(beta - 1, beta, nullDepth);
+                    nullMoveMinPly = savedMinPly;
+                    if (stopped()) return 0;
+                    if (verified < beta) score = -VALUE_INFINITE;
+                }
+
+                if (score >= beta) {
+                    stats.nullMoveCutoffs++;
+                    return score;
+                }
             }
         }
     }
-    
-    // Check for sliding pieces (rook, bishop, queen) attacks
-    // Rook directions (horizontal and vertical)
-    static const std::pair<int, int> rookDirections[] = {
-        {0, 1}, {1, 0}, {0, -1}, {-1, 0}
-    };
-    
-    // Bishop directions (diagonals)
-    static const std::pair<int, int> bishopDirections[] = {
-        {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
-    };
-    
-    // Check rook-like moves (rook and queen)
-    for (const auto& [dx, dy] : rookDirections) {
-        int x = targetX + dx;
-        int y = targetY + dy;
-        
-        while (x >= 0 && x < 8 && y >= 0 && y < 8) {
-            const BoardPosition pos(x, y);
-            auto pieceIt = pieces.find(pos);
-            
-            if (pieceIt != pieces.end()) {
-                // Found a piece
-                if (pieceIt->second.color == attackingColor &&
-                    (pieceIt->second.type == PieceType::ROOK || 
-                     pieceIt->second.type == PieceType::QUEEN)) {
-                    return true;
+
+    const int prevPiece = ply > 0 ? frames[ply - 1].piece : -1;
+    const int prevTo = ply > 0 ? moveTo(frames[ply - 1].move) : 0;
+    MovePicker picker(pos, frame.picker, ttMove, moveHistory, frame.killers, prevPiece, prevTo,
+                      continuationAt(1), continuationAt(2));
+
+    const int originalAlpha = alpha;
+    int bestScore = -VALUE_INFINITE;
+    Move bestMove = NO_MOVE;
+
+    int quietCount = 0;
+    int moveCount = 0;
+
+    // Quiet moves this far below alpha near the leaves are not worth searching
+    const bool futilityAllowed = features.futility && !pvNode && !inCheck && depth <= 6 &&
+                                 !isMateScore(alpha) && staticEval + FUTILITY_MARGIN * (depth + 1) <= alpha;
+
+    UndoInfo undo;
+    Move move;
+    while ((move = picker.next()) != NO_MOVE) {
+        if (rootNode && !rootMoves.empty() &&
+            std::find(rootMoves.begin(), rootMoves.end(), move) == rootMoves.end()) {
+            continue;
+        }
+        moveCount++;
+        const bool quiet = !isCapture(move) && !isPromotion(move);
+        const int piece = pieceIndex(pos.sideToMove(), pos.typeOn(moveFrom(move)));
+        frame.move = move;
+        frame.piece = piece;
+
+        pos.makeMove(move, undo);
+        const bool givesCheck = pos.inCheck();
+
+        // Futility pruning never drops the first move, checks or tactical moves
+        if (futilityAllowed && quiet && moveCount > 1 && !givesCheck) {
+            pos.unmakeMove(move, undo);
+            stats.futilityPrunes++;
+            continue;
+        }
+
+        if (useNNUE) updateAccumulator(accumulators[ply], accumulators[ply + 1], pos, move, undo);
+        ply++;
+        nodes++;
+
+        // Checks are searched a ply deeper, but only while the line is not
+        // already twice as long as the iteration's depth
+        int newDepth = depth - 1;
+        if (features.checkExtensions && givesCheck && ply < 2 * rootDepth) {
+            stats.checkExtensions++;
+            newDepth++;
+        }
+
+        // Principal variation search: full window for the first move, null
+        // window for the rest, re-searching only moves that raise alpha.
+        // Late quiet moves are searched reduced first.
+        int score;
+        if (moveCount == 1) {
+            score = -search(-beta, -alpha, newDepth);
+        } else {
+            int reduction = 0;
+            if (features.lateMoveReductions && depth >= 3 && quiet && !inCheck && !givesCheck) {
+                reduction = lmrReduction(depth, moveCount) - (pvNode ? 1 : 0);
+                reduction = reduction < 0 ? 0 : (reduction > newDepth - 1 ? newDepth - 1 : reduction);
+            }
+
+            if (reduction > 0) {
+                stats.lmrReductions++;
+                score = -search(-alpha - 1, -alpha, newDepth - reduction);
+                if (score > alpha) {
+                    stats.lmrResearches++;
+                    score = -search(-alpha - 1, -alpha, newDepth);
                 }
-                // Any other piece blocks this direction
-                break;
+            } else {
+                score = -search(-alpha - 1, -alpha, newDepth);
+            }
+            if (score > alpha && score < beta) {
+                score = -search(-beta, -alpha, newDepth);
             }
-            
-            // Continue in the same direction
-            x += dx;
-            y += dy;
         }
-    }
-    
-    // Check bishop-like moves (bishop and queen)
-    for (const auto& [dx, dy] : bishopDirections) {
-        int x = targetX + dx;
-        int y = targetY + dy;
-        
-        while (x >= 0 && x < 8 && y >= 0 && y < 8) {
-            const BoardPosition pos(x, y);
-            auto pieceIt = pieces.find(pos);
-            
-            if (pieceIt != pieces.end()) {
-                // Found a piece
-                if (pieceIt->second.color == attackingColor &&
-                    (pieceIt->second.type == PieceType::BISHOP || 
-                     pieceIt->second.type == PieceType::QUEEN)) {
-                    return true;
+
+        ply--;
+        pos.unmakeMove(move, undo);
+
+        // The score of an aborted subtree is meaningless
+        if (stopped()) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                bestMove = move;
+
+                // This move followed by the child's line is the new principal variation
+                const SearchFrame& child = frames[ply + 1];
+                frame.pv[ply] = move;
+                for (int j = ply + 1; j < child.pvLength; ++j) {
+                    frame.pv[j] = child.pv[j];
+                }
+                frame.pvLength = child.pvLength;
+
+                if (alpha >= beta) {
+                    TRACE(recordCutoff(moveCount));
+                    if (quiet) updateQuietStats(move, depth, quietCount);
+                    break;
                 }
-                // Any other piece blocks this direction
-                break;
             }
-            
-            // Continue in the same direction
-            x += dx;
-            y += dy;
+        }
+
+        if (quiet && quietCount < MAX_QUIETS_TRIED) {
+            frame.quietsTried[quietCount] = move;
+            frame.quietPieces[quietCount++] = piece;
         }
     }
-    
-    // No attacks found
-    return false;
-} 
\ No newline at end of file
+
+    if (moveCount == 0) {
+        return inCheck ? -VALUE_MATE + ply : 0;
+    }
+
+    const Bound bound = bestScore >= beta ? BOUND_LOWER
+                      : (alpha > originalAlpha ? BOUND_EXACT : BOUND_UPPER);
+    table.store(key, bestMove, scoreToTT(bestScore, ply), staticEval, depth, bound);
+
+    return bestScore;
+}
+
+SearchResult SearchWorker::iterate(const SearchLimits& searchLimits, TimeManager* timeManager,
+                                   const IterationCallback& onIteration) {
+    limits = &searchLimits;
+    time = timeManager;
+    SearchResult result;
+    result.pv.reserve(MAX_PLY);         // So that copying each iteration's PV never reallocates
+    TRACE(activeTrace = &trace);
+
+    for (int iteration = 1; iteration <= limits->depth && iteration < MAX_PLY; ++iteration) {
+        // Odd helpers run one ply ahead so the threads spread over two depths
+        // and fill the table for each other instead of repeating the same work
+        const int depth = iteration + (threadIndex & 1);
+        if (depth >= MAX_PLY) break;
+
+        rootDepth = depth;
+        const int score = search(-VALUE_INFINITE, VALUE_INFINITE, depth);
+
+        // An interrupted iteration is only used when there is nothing better
+        const bool interrupted = stopped();
+        const SearchFrame& root = frames[0];
+        if (interrupted && (root.pvLength == 0 || result.bestMove != NO_MOVE)) break;
+
+        result.bestMove = root.pvLength > 0 ? root.pv[0] : NO_MOVE;
+        result.score = score;
+        result.depth = depth;
+        result.pv.assign(root.pv, root.pv + root.pvLength);
+        result.nodes = nodes;
+        result.timeMs = elapsedMs();
+        result.stats = stats;
+        result.trace = trace;
+
+        if (threadIndex == 0 && onIteration && !interrupted) onIteration(result);
+
+        // No legal moves: nothing deeper to find
+        if (interrupted || result.bestMove == NO_MOVE) break;
+
+        // A mate found within the searched depth will not get any shorter
+        const int absScore = score < 0 ? -score : score;
+        if (absScore >= VALUE_MATE_IN_MAX_PLY && VALUE_MATE - absScore <= depth) break;
+
+        // Past the soft limit an iteration is unlikely to finish in time; while
+        // pondering keep going, the clock restarts on ponderhit
+        if (time && time->iterationDone(depth, result.bestMove, score, result.timeMs) && !pondering.load()) {
+            break;
+        }
+    }
+
+    result.nodes = nodes;
+    result.stats = stats;
+    result.trace = trace;
+    TRACE(activeTrace = nullptr);
+    return result;
+}
+
+SearchResult searchPosition(const Position& pos, const SearchLimits& limits,
+                            const std::vector<Key>& history, const IterationCallback& onIteration) {
+    TranspositionTable& table = limits.table ? *limits.table : TT;
+    const SearchFeatures features = limits.features ? *limits.features : searchFeatures;
+    table.newSearch();
+    const long long startMs = nowMs();
+    TimeManager timeManager;
+    timeManager.init(limits, pos.sideToMove());
+
+    // Root moves: those the GUI asked for, narrowed to the ones keeping the
+    // tablebase result when the root is in the tables
+    std::vector<Move> rootMoves = limits.searchMoves;
+    if (rootMoves.empty()) {
+        MoveList moves;
+        generateLegalMoves(pos, moves);
+        rootMoves.assign(moves.begin(), moves.end());
+    }
+    bool rootInTablebase = false;
+    int tbScore = 0;
+    if (!rootMoves.empty() && pos.castlingRights() == 0 &&
+        popCount(pos.pieces()) <= tablebaseMaxPieces()) {
+        Position root = pos;
+        rootInTablebase = probeRoot(root, history, rootMoves, tbScore);
+    }
+
+    // The search below a tablebase root only decides between equally ranked
+    // moves; its score means little, so report the tablebase score instead
+    auto withTablebaseScore = [&](SearchResult result) {
+        if (rootInTablebase && !isMateScore(result.score)) result.score = tbScore;
+        return result;
+    };
+    IterationCallback reportIteration = onIteration;
+    if (rootInTablebase && onIteration) {
+        reportIteration = [&](const SearchResult& result) { onIteration(withTablebaseScore(result)); };
+    }
+
+    std::atomic<bool> stop(false);
+    std::vector<std::unique_ptr<SearchWorker>> workers;
+    for (int i = 0; i < searchThreadCount; ++i) {
+        workers.push_back(std::make_unique<SearchWorker>(pos, history, i, startMs, stop, features, table,
+                                                      rootMoves, rootInTablebase));
+    }
+
+    // Helpers keep deepening until the main thread finishes its search
+    SearchLimits helperLimits = limits;
+    helperLimits.depth = MAX_PLY - 1;
+
+    std::vector<SearchResult> results(workers.size());
+    std::vector<std::thread> helpers;
+    for (std::size_t i = 1; i < workers.size(); ++i) {
+        helpers.emplace_back([&, i] { results[i] = workers[i]->iterate(helperLimits, nullptr, nullptr); });
+    }
+
+    results[0] = workers[0]->iterate(limits, &timeManager, reportIteration);
+    stop.store(true, std::memory_order_relaxed);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    // Report the deepest completed iteration, preferring the main thread. Helpers
+    // search past a depth limit until the main thread stops, so a result deeper
+    // than the limit is not taken: "go depth N" answers at depth N
+    SearchResult best = results[0];
+    long long totalNodes = 0;
+    SearchStats totalStats;
+    TraceCounters totalTrace;
+    for (const SearchResult& result : results) {
+        totalNodes += result.nodes;
+        totalStats.add(result.stats);
+        totalTrace.add(result.trace);
+        if (result.depth > best.depth && result.depth <= limits.depth && result.bestMove != NO_MOVE) {
+            best = result;
+        }
+    }
+    best.nodes = totalNodes;
+    best.stats = totalStats;
+    best.trace = totalTrace;
+    best.timeMs = workers[0]->elapsedMs();
+    best = withTablebaseScore(best);
+
+    // Stopped before the first iteration produced a move: any legal move beats none
+    if (best.bestMove == NO_MOVE) {
+        if (!rootMoves.empty()) {
+            best.bestMove = rootMoves[0];
+            best.pv.assign(1, rootMoves[0]);
+        }
+    }
+    return best;
+}
+
+// Function to find the best move using alpha-beta search
+Move findBestMove(const Position& pos, int searchDepth) {
+    SearchLimits limits;
+    limits.depth = searchDepth;
+    return searchPosition(pos, limits).bestMove;
+}
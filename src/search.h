@@ -1,11 +1,138 @@
 #ifndef SEARCH_H
 #define SEARCH_H
 
+#include <functional>
 #include <string>
-#include "pieces_placement.h"
+#include <vector>
+#include "position.h"
+#include "move.h"
+#include "trace.h"
 
-// Forward declarations of search-related functions
-void calculateMovesForPosition(const std::string& fen);
-void calculateMovesForStartingPosition();
+class TranspositionTable;
 
-#endif // SEARCH_H 
\ No newline at end of file
+// Search bounds and score conventions
+constexpr int MAX_PLY = 128;
+constexpr int VALUE_MATE = 32000;
+constexpr int VALUE_INFINITE = 32001;
+constexpr int VALUE_NONE = 32002;             // "No score", e.g. an eval not stored in the TT
+constexpr int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+constexpr bool isMateScore(int score) {
+    return score >= VALUE_MATE_IN_MAX_PLY || score <= -VALUE_MATE_IN_MAX_PLY;
+}
+
+// Moves to mate for a mate score (negative when getting mated, 0 when already mated);
+// only meaningful when isMateScore(score)
+constexpr int mateIn(int score) {
+    return score >= VALUE_MATE_IN_MAX_PLY ? (VALUE_MATE - score + 1) / 2
+         : score <= -VALUE_MATE_IN_MAX_PLY ? -(VALUE_MATE + score) / 2
+         : 0;
+}
+
+// "cp 35", "mate 3" or "mate 0" for a mated root, as UCI reports scores
+inline std::string scoreToUCI(int score) {
+    return isMateScore(score) ? "mate " + std::to_string(mateIn(score)) : "cp " + std::to_string(score);
+}
+
+// Upper bound for the configurable thread count
+constexpr int MAX_SEARCH_THREADS = 256;
+
+// Search techniques that can be switched off, e.g. to measure what each one is worth
+struct SearchFeatures {
+    bool nullMove = true;               // Null-move pruning, verified in zugzwang-prone positions
+    bool lateMoveReductions = true;
+    bool futility = true;               // Skip quiet moves that cannot raise alpha near the leaves
+    bool reverseFutility = true;        // Cut nodes whose static eval is far above beta
+    bool razoring = true;               // Drop into qsearch when the static eval is far below alpha
+    bool checkExtensions = true;
+};
+
+// What the search is allowed to do (zero means "no limit" for every field but depth)
+struct SearchLimits {
+    int depth = MAX_PLY - 1;
+    long long nodes = 0;
+    int moveTime = 0;                   // Exact time for this move in ms
+    int time[COLOR_COUNT] = {0, 0};     // Remaining clock time in ms, by color
+    int increment[COLOR_COUNT] = {0, 0};
+    int movesToGo = 0;
+    bool infinite = false;              // Search until stopped
+    std::vector<Move> searchMoves;      // Root moves to consider; empty for all of them
+
+    // Overrides for engines sharing one process (self-play); null for the global settings
+    const SearchFeatures* features = nullptr;
+    TranspositionTable* table = nullptr;
+};
+
+// How often each technique fired, summed over all search threads
+struct SearchStats {
+    long long nullMoveTries = 0;
+    long long nullMoveCutoffs = 0;
+    long long nullMoveVerifications = 0;   // Cutoffs re-checked with a real search
+    long long lmrReductions = 0;
+    long long lmrResearches = 0;           // Reduced moves that beat alpha and were searched again
+    long long futilityPrunes = 0;
+    long long reverseFutilityPrunes = 0;
+    long long razorPrunes = 0;
+    long long checkExtensions = 0;
+    long long tbHits = 0;                  // Successful tablebase probes
+
+    void add(const SearchStats& other);
+};
+
+// Outcome of the last completed iteration
+struct SearchResult {
+    Move bestMove = NO_MOVE;
+    int score = 0;
+    int depth = 0;
+    long long nodes = 0;
+    long long timeMs = 0;
+    std::vector<Move> pv;
+    SearchStats stats;
+    TraceCounters trace;                // All zero unless built with USE_TRACE
+};
+
+// Called by the main search thread after every completed iteration
+using IterationCallback = std::function<void(const SearchResult&)>;
+
+/**
+ * @brief Iterative-deepening principal variation search backed by the shared TT
+ *
+ * Searches depth 1, 2, ... up to limits.depth and returns the result of the
+ * deepest completed iteration. With more than one thread the search is Lazy
+ * SMP: every thread searches the same root on its own copy of the position.
+ * history holds the keys of the game's earlier positions, oldest first, so
+ * that repetitions of them are scored as draws. When the root is in the
+ * Syzygy tablebases, only the moves that keep its DTZ result are searched.
+ * Searches of different positions may run side by side on separate threads
+ * (as batch analysis does); they share the TT and the stop flag.
+ */
+SearchResult searchPosition(const Position& pos, const SearchLimits& limits,
+                            const std::vector<Key>& history = {},
+                            const IterationCallback& onIteration = nullptr);
+
+/**
+ * @brief Signals for a search running on another thread
+ *
+ * prepareSearch() must run on the controlling thread before a search is
+ * started on another one; with ponder set the search ignores its time limits
+ * until ponderHit(). requestStop() ends the search within a few nodes and
+ * stays in effect until the next prepareSearch().
+ */
+void prepareSearch(bool ponder);
+void requestStop();
+bool isStopRequested();
+void ponderHit();
+bool isPondering();
+
+// Number of search threads (clamped to 1..MAX_SEARCH_THREADS); safe to change between searches
+void setSearchThreads(int threads);
+int getSearchThreads();
+
+// Techniques used by the next searches; safe to change between searches
+void setSearchFeatures(const SearchFeatures& features);
+SearchFeatures getSearchFeatures();
+
+// Picks a move for the side to move by searching to the given depth
+Move findBestMove(const Position& pos, int searchDepth);
+
+#endif // SEARCH_H 
@@ -0,0 +1,643 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "selfplay.h"
+#include "book.h"
+#include "child_process.h"
+#include "game_logic.h"
+#include "movegen.h"
+#include "san.h"
+#include "tt.h"
+
+// How long an external engine may take to start up and answer "isready"
+constexpr int UCI_STARTUP_TIMEOUT_MS = 10000;
+
+// Slack given to an external engine beyond its clock before it forfeits
+constexpr int UCI_MOVE_GRACE_MS = 1000;
+
+// PGN movetext lines are wrapped at this width
+constexpr std::size_t PGN_LINE_WIDTH = 80;
+
+static long long nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Search techniques by their command-line names
+struct FeatureName {
+    const char* name;
+    bool SearchFeatures::*flag;
+};
+
+static const FeatureName FEATURE_NAMES[] = {
+    {"nmp", &SearchFeatures::nullMove},
+    {"lmr", &SearchFeatures::lateMoveReductions},
+    {"futility", &SearchFeatures::futility},
+    {"rfp", &SearchFeatures::reverseFutility},
+    {"razoring", &SearchFeatures::razoring},
+    {"checkext", &SearchFeatures::checkExtensions},
+};
+
+// A player of one game at a time
+class Player {
+public:
+    virtual ~Player() = default;
+
+    // Forgets everything learned in the previous game; false if the engine stopped answering
+    virtual bool newGame() = 0;
+
+    // The move to play, or NO_MOVE if the engine failed to give a legal one in time
+    virtual Move think(const ChessGameLogic& game, const std::string& startFen, const std::vector<Move>& moves,
+                       const int timeLeft[COLOR_COUNT], int incrementMs) = 0;
+};
+
+// This engine, searching on the calling thread with its own hash table
+class InternalPlayer : public Player {
+public:
+    InternalPlayer(const SearchFeatures& searchFeatures, int hashMB) : features(searchFeatures) {
+        table.resize(static_cast<std::size_t>(hashMB));
+    }
+
+    bool newGame() override {
+        table.clear();
+        return true;
+    }
+
+    Move think(const ChessGameLogic& game, const std::string&, const std::vector<Move>&,
+               const int timeLeft[COLOR_COUNT], int incrementMs) override {
+        SearchLimits limits;
+        for (int c = 0; c < COLOR_COUNT; ++c) {
+            limits.time[c] = std::max(1, timeLeft[c]);      // 0 would mean no time limit
+            limits.increment[c] = incrementMs;
+        }
+        limits.features = &features;
+        limits.table = &table;
+
+        // The search wants the keys of the positions before the current one
+        const std::vector<Key>& keys = game.getPositionHistory();
+        const std::vector<Key> history(keys.begin(), keys.end() - 1);
+        return searchPosition(game.getPosition(), limits, history).bestMove;
+    }
+
+private:
+    const SearchFeatures features;
+    TranspositionTable table;
+};
+
+// Another engine, driven over UCI as a child process
+class UciPlayer : public Player {
+public:
+    ~UciPlayer() override {
+        process.writeLine("quit");
+        process.close();
+    }
+
+    bool start(const std::string& command, int hashMB) {
+        if (!process.start(command)) return false;
+        process.writeLine("uci");
+        if (!waitFor("uciok", UCI_STARTUP_TIMEOUT_MS)) return false;
+        process.writeLine("setoption name Hash value " + std::to_string(hashMB));
+        return isReady();
+    }
+
+    bool newGame() override {
+        process.writeLine("ucinewgame");
+        return isReady();
+    }
+
+    Move think(const ChessGameLogic& game, const std::string& startFen, const std::vector<Move>& moves,
+               const int timeLeft[COLOR_COUNT], int incrementMs) override {
+        std::string position = "position fen " + startFen;
+        if (!moves.empty()) {
+            position += " moves";
+            for (Move move : moves) position += " " + moveToUCI(move);
+        }
+        process.writeLine(position);
+        process.writeLine("go wtime " + std::to_string(timeLeft[0]) + " btime " + std::to_string(timeLeft[1]) +
+                          " winc " + std::to_string(incrementMs) + " binc " + std::to_string(incrementMs));
+
+        const int side = static_cast<int>(game.getCurrentTurn());
+        std::string line;
+        if (!waitFor("bestmove", timeLeft[side] + UCI_MOVE_GRACE_MS, &line)) return NO_MOVE;
+
+        std::istringstream words(line);
+        std::string keyword, text;
+        words >> keyword >> text;
+        MoveList legal;
+        generateLegalMoves(game.getPosition(), legal);
+        for (Move move : legal) {
+            if (moveToUCI(move) == text) return move;
+        }
+        return NO_MOVE;
+    }
+
+private:
+    ChildProcess process;
+
+    bool isReady() {
+        process.writeLine("isready");
+        return waitFor("readyok", UCI_STARTUP_TIMEOUT_MS);
+    }
+
+    // Reads output until a line starting with token, skipping "info" and the like
+    bool waitFor(const std::string& token, int timeoutMs, std::string* found = nullptr) {
+        const long long deadline = nowMs() + timeoutMs;
+        std::string line;
+        while (process.readLine(line, static_cast<int>(std::max(0LL, deadline - nowMs())))) {
+            if (line.compare(0, token.size(), token) == 0) {
+                if (found) *found = line;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+static std::unique_ptr<Player> makePlayer(const EngineSpec& spec, int hashMB) {
+    if (spec.command.empty()) return std::make_unique<InternalPlayer>(spec.features, hashMB);
+
+    auto player = std::make_unique<UciPlayer>();
+    if (!player->start(spec.command, hashMB)) {
+        std::cerr << "Warning: Engine '" << spec.command << "' did not start or does not speak UCI" << std::endl;
+        return nullptr;
+    }
+    return player;
+}
+
+// One finished game
+struct GameRecord {
+    int round = 0;
+    int white = 0;                      // Index of the engine playing White
+    std::string startFen;
+    std::vector<Move> moves;
+    std::string result;                 // "1-0", "0-1" or "1/2-1/2"
+    std::string reason;                 // Why the game ended, e.g. "White mates"
+    std::string termination;            // PGN Termination tag
+};
+
+// State shared by the worker threads of one match
+struct Match {
+    const SelfPlayOptions& options;
+    std::vector<std::string> openings;
+
+    OpeningBook book;                   // Not thread-safe: used under bookMutex
+    std::mutex bookMutex;
+    std::map<int, std::vector<Move>> bookLines;     // Book moves of each pair of games
+
+    std::atomic<int> nextGame{0};
+    std::atomic<bool> stop{false};
+
+    std::mutex resultMutex;
+    int wins = 0;                       // From the first engine's point of view
+    int losses = 0;
+    int draws = 0;
+    std::ofstream pgn;
+    std::string date;
+
+    explicit Match(const SelfPlayOptions& opts) : options(opts) {}
+};
+
+// Reads the first four FEN fields (plus move counters if present) of every line
+static bool loadOpenings(const std::string& path, std::vector<std::string>& openings) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Warning: Could not open openings file '" << path << "'" << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string placement, side, castling, enPassant;
+        if (!(fields >> placement >> side >> castling >> enPassant) || placement[0] == '#') continue;
+
+        int halfmove = 0;
+        int fullmove = 1;
+        if (!(fields >> halfmove >> fullmove)) {
+            halfmove = 0;
+            fullmove = 1;
+        }
+        const std::string fen = placement + " " + side + " " + castling + " " + enPassant + " " +
+                                std::to_string(halfmove) + " " + std::to_string(fullmove);
+        Position pos;
+        if (pos.setFromFEN(fen)) {
+            openings.push_back(fen);
+        } else {
+            std::cerr << "Warning: Skipping invalid opening '" << line << "'" << std::endl;
+        }
+    }
+    return true;
+}
+
+// Both games of a pair follow the same book line, chosen when the first of them starts
+static std::vector<Move> bookLine(Match& match, int pair, const std::string& fen) {
+    std::lock_guard<std::mutex> lock(match.bookMutex);
+    auto found = match.bookLines.find(pair);
+    if (found != match.bookLines.end()) {
+        std::vector<Move> line = std::move(found->second);
+        match.bookLines.erase(found);
+        return line;
+    }
+
+    std::vector<Move> line;
+    if (match.book.isOpen()) {
+        Position pos;
+        pos.setFromFEN(fen);
+        for (int ply = 0; ply < match.options.bookPlies; ++ply) {
+            const Move move = match.book.probe(pos);
+            if (move == NO_MOVE) break;
+            line.push_back(move);
+            pos.doMove(move);
+        }
+    }
+    match.bookLines[pair] = line;
+    return line;
+}
+
+static void playMove(ChessGameLogic& game, Move move) {
+    game.executeMove(toBoardPosition(moveFrom(move)), toBoardPosition(moveTo(move)),
+                     isPromotion(move) ? promotionType(move) : PieceType::QUEEN);
+}
+
+static const char* colorName(PieceColor color) {
+    return color == PieceColor::WHITE ? "White" : "Black";
+}
+
+static void playGame(Match& match, int gameIndex, Player* players[2], GameRecord& record) {
+    const SelfPlayOptions& options = match.options;
+    const int pair = gameIndex / 2;
+
+    record.round = gameIndex + 1;
+    record.white = gameIndex % 2;
+    record.startFen = match.openings[pair % match.openings.size()];
+
+    ChessGameLogic game(record.startFen);
+    for (Move move : bookLine(match, pair, record.startFen)) {
+        playMove(game, move);
+        record.moves.push_back(move);
+    }
+
+    int timeLeft[COLOR_COUNT] = {options.baseMs, options.baseMs};
+
+    for (;;) {
+        const PieceColor side = game.getCurrentTurn();
+        const char* sideName = colorName(side);
+        const char* winner = (side == PieceColor::WHITE) ? "0-1" : "1-0";
+
+        switch (game.getGameState()) {
+            case GameState::CHECKMATE:
+                record.result = winner;
+                record.reason = std::string(colorName(opposite(side))) + " mates";
+                record.termination = "normal";
+                return;
+            case GameState::STALEMATE:
+            case GameState::DRAW_FIFTY:
+            case GameState::DRAW_REPETITION:
+            case GameState::DRAW_MATERIAL: {
+                const GameState state = game.getGameState();
+                record.result = "1/2-1/2";
+                record.reason = state == GameState::STALEMATE ? "Stalemate"
+                              : state == GameState::DRAW_FIFTY ? "Fifty-move rule"
+                              : state == GameState::DRAW_REPETITION ? "Threefold repetition"
+                              : "Insufficient material";
+                record.termination = "normal";
+                return;
+            }
+            default:
+                break;
+        }
+        if (static_cast<int>(record.moves.size()) >= options.maxPlies) {
+            record.result = "1/2-1/2";
+            record.reason = "Draw adjudicated after " + std::to_string(options.maxPlies) + " plies";
+            record.termination = "adjudication";
+            return;
+        }
+
+        Player* player = players[(side == PieceColor::WHITE) == (record.white == 0) ? 0 : 1];
+        const long long start = nowMs();
+        const Move move = player->think(game, record.startFen, record.moves, timeLeft, options.incrementMs);
+        timeLeft[static_cast<int>(side)] -= static_cast<int>(nowMs() - start);
+
+        if (move == NO_MOVE) {
+            record.result = winner;
+            record.reason = std::string(sideName) + " makes no legal move";
+            record.termination = "rules infraction";
+            return;
+        }
+        if (timeLeft[static_cast<int>(side)] < 0) {
+            record.result = winner;
+            record.reason = std::string(sideName) + " loses on time";
+            record.termination = "time forfeit";
+            return;
+        }
+        timeLeft[static_cast<int>(side)] += options.incrementMs;
+
+        playMove(game, move);
+        record.moves.push_back(move);
+    }
+}
+
+// Seconds as PGN writes them in a TimeControl tag ("10", "0.1")
+static std::string secondsText(int ms) {
+    std::ostringstream text;
+    text << ms / 1000.0;
+    return text.str();
+}
+
+static std::string formatPgn(const Match& match, const GameRecord& record) {
+    const SelfPlayOptions& options = match.options;
+    std::ostringstream pgn;
+    pgn << "[Event \"Phosphor self-play\"]\n"
+        << "[Site \"?\"]\n"
+        << "[Date \"" << match.date << "\"]\n"
+        << "[Round \"" << record.round << "\"]\n"
+        << "[White \"" << options.engines[record.white].name << "\"]\n"
+        << "[Black \"" << options.engines[1 - record.white].name << "\"]\n"
+        << "[Result \"" << record.result << "\"]\n";
+    if (record.startFen != START_FEN) {
+        pgn << "[SetUp \"1\"]\n[FEN \"" << record.startFen << "\"]\n";
+    }
+    pgn << "[PlyCount \"" << record.moves.size() << "\"]\n"
+        << "[TimeControl \"" << secondsText(options.baseMs) << "+" << secondsText(options.incrementMs) << "\"]\n"
+        << "[Termination \"" << record.termination << "\"]\n\n";
+
+    Position pos;
+    pos.setFromFEN(record.startFen);
+    std::string line;
+    auto append = [&](const std::string& word) {
+        if (!line.empty() && line.size() + 1 + word.size() > PGN_LINE_WIDTH) {
+            pgn << line << "\n";
+            line.clear();
+        }
+        if (!line.empty()) line += ' ';
+        line += word;
+    };
+    for (std::size_t i = 0; i < record.moves.size(); ++i) {
+        std::string word;
+        if (pos.sideToMove() == PieceColor::WHITE) {
+            word = std::to_string(pos.fullmoveNumber()) + ". ";
+        } else if (i == 0) {
+            word = std::to_string(pos.fullmoveNumber()) + "... ";
+        }
+        word += moveToSAN(pos, record.moves[i]);
+        append(word);
+        pos.doMove(record.moves[i]);
+    }
+    append("{" + record.reason + "}");
+    append(record.result);
+    pgn << line << "\n\n";
+    return pgn.str();
+}
+
+// Expected score for an Elo difference, and back
+static double scoreFromElo(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+static double eloFromScore(double score) {
+    score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+    return 400.0 * std::log10(score / (1.0 - score));
+}
+
+// Prints the running totals; returns true when the SPRT has decided
+static bool reportStatus(const Match& match) {
+    const SelfPlayOptions& options = match.options;
+    const int games = match.wins + match.losses + match.draws;
+    const double score = (match.wins + 0.5 * match.draws) / games;
+
+    // Variance of a single game's result, the basis of both the error bars and the SPRT
+    const double variance = (match.wins * std::pow(1.0 - score, 2) + match.draws * std::pow(0.5 - score, 2) +
+                             match.losses * std::pow(score, 2)) / games;
+    const double margin = 1.96 * std::sqrt(variance / games);
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Score of " << options.engines[0].name << " vs " << options.engines[1].name << ": "
+              << match.wins << " - " << match.losses << " - " << match.draws
+              << " [" << score << "] " << games << std::endl;
+    std::cout << std::setprecision(1)
+              << "Elo difference: " << eloFromScore(score) << " +/- "
+              << (eloFromScore(score + margin) - eloFromScore(score - margin)) / 2 << std::endl;
+
+    bool decided = false;
+    if (options.sprt && variance > 0.0) {
+        const double s0 = scoreFromElo(options.elo0);
+        const double s1 = scoreFromElo(options.elo1);
+        const double llr = games * (s1 - s0) * (2.0 * score - s0 - s1) / (2.0 * variance);
+        const double lower = std::log(options.beta / (1.0 - options.alpha));
+        const double upper = std::log((1.0 - options.beta) / options.alpha);
+        std::cout << std::setprecision(2)
+                  << "SPRT: llr " << llr << " (" << lower << ", " << upper << ") ["
+                  << options.elo0 << ", " << options.elo1 << "]";
+        if (llr >= upper) {
+            std::cout << " - H1 was accepted";
+            decided = true;
+        } else if (llr <= lower) {
+            std::cout << " - H0 was accepted";
+            decided = true;
+        }
+        std::cout << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    return decided;
+}
+
+// Readies a player for the next game. An engine that crashed (e.g. mid-game,
+// losing that game) fails newGame() and is started afresh; false if that fails too.
+static bool prepareForGame(const EngineSpec& spec, int hashMB, std::unique_ptr<Player>& player) {
+    if (player->newGame()) return true;
+    std::cerr << "Warning: Engine '" << spec.name << "' stopped responding, restarting it" << std::endl;
+    player = makePlayer(spec, hashMB);
+    return player && player->newGame();
+}
+
+static void matchWorker(Match& match) {
+    const SelfPlayOptions& options = match.options;
+    std::unique_ptr<Player> engines[2] = {makePlayer(options.engines[0], options.hashMB),
+                                          makePlayer(options.engines[1], options.hashMB)};
+    if (!engines[0] || !engines[1]) {
+        match.stop = true;
+        return;
+    }
+
+    while (!match.stop) {
+        const int gameIndex = match.nextGame++;
+        if (gameIndex >= options.games) return;
+
+        // A game no engine could start is not played, so it never reaches the statistics
+        if (!prepareForGame(options.engines[0], options.hashMB, engines[0]) ||
+            !prepareForGame(options.engines[1], options.hashMB, engines[1])) {
+            std::cerr << "Warning: Stopping the match, an engine could not be restarted" << std::endl;
+            match.stop = true;
+            return;
+        }
+        Player* players[2] = {engines[0].get(), engines[1].get()};
+
+        GameRecord record;
+        playGame(match, gameIndex, players, record);
+        const std::string pgn = formatPgn(match, record);
+
+        std::lock_guard<std::mutex> lock(match.resultMutex);
+        if (record.result == "1/2-1/2") {
+            match.draws++;
+        } else if ((record.result == "1-0") == (record.white == 0)) {
+            match.wins++;
+        } else {
+            match.losses++;
+        }
+        if (match.pgn.is_open()) match.pgn << pgn << std::flush;
+
+        std::cout << "Finished game " << record.round << " (" << options.engines[record.white].name << " vs "
+                  << options.engines[1 - record.white].name << "): " << record.result
+                  << " {" << record.reason << "}" << std::endl;
+        if (reportStatus(match)) match.stop = true;
+    }
+}
+
+// "default", "uci:<command>" or a list such as "no-lmr,no-nmp"
+static bool parseEngineSpec(const std::string& text, EngineSpec& spec) {
+    spec = EngineSpec();
+    spec.name = "Phosphor";
+    if (text == "default") return true;
+
+    if (text.compare(0, 4, "uci:") == 0) {
+        spec.command = text.substr(4);
+        const std::string program = spec.command.substr(0, spec.command.find(' '));
+        const std::size_t slash = program.find_last_of("/\\");
+        spec.name = (slash == std::string::npos) ? program : program.substr(slash + 1);
+        return !spec.command.empty();
+    }
+
+    std::istringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        const FeatureName* feature = nullptr;
+        for (const FeatureName& candidate : FEATURE_NAMES) {
+            if (item == std::string("no-") + candidate.name) feature = &candidate;
+        }
+        if (!feature) {
+            std::cerr << "Warning: Unknown engine setting '" << item << "'" << std::endl;
+            return false;
+        }
+        spec.features.*(feature->flag) = false;
+    }
+    spec.name = "Phosphor(" + text + ")";
+    return true;
+}
+
+bool parseSelfPlayOptions(const std::vector<std::string>& args, SelfPlayOptions& options) {
+    parseEngineSpec("default", options.engines[0]);
+    parseEngineSpec("default", options.engines[1]);
+
+    for (std::size_t i = 0; i < args.size(); i += 2) {
+        const std::string& name = args[i];
+        if (i + 1 >= args.size()) {
+            std::cerr << "Warning: Missing value for '" << name << "'" << std::endl;
+            return false;
+        }
+        const std::string& value = args[i + 1];
+
+        if (name == "games") {
+            options.games = std::max(1, std::atoi(value.c_str()));
+        } else if (name == "concurrency") {
+            options.concurrency = std::atoi(value.c_str());
+        } else if (name == "tc") {
+            const std::size_t plus = value.find('+');
+            options.baseMs = static_cast<int>(std::atof(value.substr(0, plus).c_str()) * 1000);
+            options.incrementMs = (plus == std::string::npos)
+                                ? 0 : static_cast<int>(std::atof(value.substr(plus + 1).c_str()) * 1000);
+            if (options.baseMs <= 0) {
+                std::cerr << "Warning: Invalid time control '" << value << "'" << std::endl;
+                return false;
+            }
+        } else if (name == "openings") {
+            options.openings = value;
+        } else if (name == "book") {
+            options.book = value;
+        } else if (name == "bookplies") {
+            options.bookPlies = std::atoi(value.c_str());
+        } else if (name == "pgn") {
+            options.pgnPath = value;
+        } else if (name == "hash") {
+            options.hashMB = std::max(1, std::atoi(value.c_str()));
+        } else if (name == "maxplies") {
+            options.maxPlies = std::max(1, std::atoi(value.c_str()));
+        } else if (name == "sprt") {
+            const std::size_t comma = value.find(',');
+            if (comma == std::string::npos) {
+                std::cerr << "Warning: sprt expects elo0,elo1" << std::endl;
+                return false;
+            }
+            options.sprt = true;
+            options.elo0 = std::atof(value.substr(0, comma).c_str());
+            options.elo1 = std::atof(value.substr(comma + 1).c_str());
+        } else if (name == "engine1" || name == "engine2") {
+            if (!parseEngineSpec(value, options.engines[name == "engine1" ? 0 : 1])) return false;
+        } else {
+            std::cerr << "Warning: Unknown selfplay option '" << name << "'" << std::endl;
+            return false;
+        }
+    }
+
+    if (options.engines[0].name == options.engines[1].name) {
+        options.engines[0].name += "-1";
+        options.engines[1].name += "-2";
+    }
+    return true;
+}
+
+bool runSelfPlay(const SelfPlayOptions& options) {
+    Match match(options);
+    if (!options.openings.empty() && !loadOpenings(options.openings, match.openings)) return false;
+    if (match.openings.empty()) match.openings.push_back(START_FEN);
+
+    if (!options.book.empty() && !match.book.open(options.book)) {
+        std::cerr << "Warning: Could not open book '" << options.book << "'" << std::endl;
+        return false;
+    }
+    if (!options.pgnPath.empty()) {
+        match.pgn.open(options.pgnPath, std::ios::app);
+        if (!match.pgn) {
+            std::cerr << "Warning: Could not open PGN file '" << options.pgnPath << "'" << std::endl;
+            return false;
+        }
+    }
+
+    const std::time_t now = std::time(nullptr);
+    char date[16];
+    std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now));
+    match.date = date;
+
+    int concurrency = options.concurrency > 0 ? options.concurrency
+                                              : static_cast<int>(std::thread::hardware_concurrency());
+    concurrency = std::max(1, std::min(concurrency, options.games));
+
+    // Every in-process engine searches on its game's thread alone
+    const int savedThreads = getSearchThreads();
+    setSearchThreads(1);
+    prepareSearch(false);
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < concurrency; ++i) {
+        workers.emplace_back(matchWorker, std::ref(match));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    setSearchThreads(savedThreads);
+
+    const int played = match.wins + match.losses + match.draws;
+    if (played == 0) return false;
+    std::cout << "Finished match: " << played << " games played" << std::endl;
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include <string>
+#include <vector>
+#include "search.h"
+
+// One side of a match: this engine with some techniques switched off, or another UCI engine
+struct EngineSpec {
+    std::string name;                   // Used in the PGN and the statistics
+    std::string command;                // External UCI engine to run; empty for this engine in-process
+    SearchFeatures features;            // In-process engine only
+};
+
+// Settings of one self-play match
+struct SelfPlayOptions {
+    EngineSpec engines[2];
+    int games = 100;
+    int concurrency = 0;                // Games played at once; 0 for one per core
+    int baseMs = 10000;                 // Time control: starting clock and increment per side
+    int incrementMs = 100;
+    std::string openings;               // EPD/FEN start positions, each played with both colors
+    std::string book;                   // Polyglot book for the first moves of every pair of games
+    int bookPlies = 8;
+    std::string pgnPath;                // Finished games are appended here; empty for none
+    int hashMB = 16;                    // Per in-process engine
+    int maxPlies = 400;                 // Longer games are adjudicated as draws
+
+    // Sequential probability ratio test of elo0 against elo1; the match stops once it decides
+    bool sprt = false;
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+/**
+ * @brief Reads "selfplay" command-line arguments into options
+ *
+ * Keyword/value pairs: games, concurrency, tc (seconds+increment, e.g.
+ * "10+0.1"), openings, book, bookplies, pgn, hash, maxplies, sprt
+ * ("elo0,elo1"), engine1 and engine2. An engine is "default", a comma list
+ * of techniques to switch off ("no-nmp", "no-lmr", "no-futility",
+ * "no-rfp", "no-razoring", "no-checkext") or "uci:<command>" for an
+ * external engine.
+ * @return False (after printing a warning) on an unknown or incomplete argument
+ */
+bool parseSelfPlayOptions(const std::vector<std::string>& args, SelfPlayOptions& options);
+
+/**
+ * @brief Plays a match between the two engines and prints the running result
+ *
+ * Every worker thread plays one game at a time with its own pair of
+ * engines. An in-process engine has its own hash table and a single
+ * search thread; an external engine is a child process. Openings are
+ * played twice with colors reversed. Games end by the rules as tracked by
+ * ChessGameLogic (mate, stalemate, repetition, fifty moves, insufficient
+ * material), by a time forfeit or illegal move, or as a draw at maxPlies.
+ * After every game the score, Elo difference with a 95% error margin and,
+ * with SPRT on, the log-likelihood ratio are printed.
+ * @return False if an opening file, book or engine could not be opened
+ */
+bool runSelfPlay(const SelfPlayOptions& options);
+
+#endif // SELFPLAY_H
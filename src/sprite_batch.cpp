@@ -0,0 +1,57 @@
+#include "sprite_batch.h"
+
+void SpriteBatch::setTexture(const sf::Texture* atlas, const sf::IntRect& solidRect) {
+    texture = atlas;
+
+    // Sample the middle of the white area so smoothing never blends in its neighbours
+    solidTexCoord = sf::Vector2f(solidRect.left + solidRect.width / 2.0f, solidRect.top + solidRect.height / 2.0f);
+}
+
+// Two triangles per rectangle: quads are not available on every backend
+void SpriteBatch::appendRect(const sf::FloatRect& dest, const sf::FloatRect& tex, const sf::Color& color) {
+    const float left = dest.left;
+    const float top = dest.top;
+    const float right = dest.left + dest.width;
+    const float bottom = dest.top + dest.height;
+
+    const float texLeft = tex.left;
+    const float texTop = tex.top;
+    const float texRight = tex.left + tex.width;
+    const float texBottom = tex.top + tex.height;
+
+    const sf::Vertex topLeft(sf::Vector2f(left, top), color, sf::Vector2f(texLeft, texTop));
+    const sf::Vertex topRight(sf::Vector2f(right, top), color, sf::Vector2f(texRight, texTop));
+    const sf::Vertex bottomRight(sf::Vector2f(right, bottom), color, sf::Vector2f(texRight, texBottom));
+    const sf::Vertex bottomLeft(sf::Vector2f(left, bottom), color, sf::Vector2f(texLeft, texBottom));
+
+    vertices.append(topLeft);
+    vertices.append(topRight);
+    vertices.append(bottomRight);
+    vertices.append(topLeft);
+    vertices.append(bottomRight);
+    vertices.append(bottomLeft);
+}
+
+void SpriteBatch::addTexturedRect(const sf::FloatRect& dest, const sf::IntRect& source, const sf::Color& color) {
+    appendRect(dest, sf::FloatRect(static_cast<float>(source.left), static_cast<float>(source.top),
+                                   static_cast<float>(source.width), static_cast<float>(source.height)), color);
+}
+
+void SpriteBatch::addRect(const sf::FloatRect& dest, const sf::Color& color) {
+    appendRect(dest, sf::FloatRect(solidTexCoord.x, solidTexCoord.y, 0.0f, 0.0f), color);
+}
+
+void SpriteBatch::addOutline(const sf::FloatRect& rect, float thickness, const sf::Color& color) {
+    const float outerWidth = rect.width + 2 * thickness;
+    addRect(sf::FloatRect(rect.left - thickness, rect.top - thickness, outerWidth, thickness), color);
+    addRect(sf::FloatRect(rect.left - thickness, rect.top + rect.height, outerWidth, thickness), color);
+    addRect(sf::FloatRect(rect.left - thickness, rect.top, thickness, rect.height), color);
+    addRect(sf::FloatRect(rect.left + rect.width, rect.top, thickness, rect.height), color);
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target) const {
+    if (vertices.getVertexCount() == 0) return;
+    sf::RenderStates states;
+    states.texture = texture;
+    target.draw(vertices, states);
+}
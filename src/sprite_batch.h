@@ -0,0 +1,44 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+/**
+ * @brief Collects textured and solid rectangles into one vertex array
+ *
+ * Everything in a batch samples the same texture, so the whole batch is a
+ * single draw call however many rectangles it holds. Solid rectangles use a
+ * plain white area of the texture tinted by the vertex color, which lets
+ * highlights share the batch with the textured pieces. The array is kept
+ * between frames and only rebuilt when the caller clears it.
+ */
+class SpriteBatch {
+public:
+    SpriteBatch() : vertices(sf::Triangles) {}
+
+    // texture must outlive the batch; solidRect must be a fully opaque white area of it
+    void setTexture(const sf::Texture* texture, const sf::IntRect& solidRect);
+
+    void clear() { vertices.clear(); }
+    std::size_t rectCount() const { return vertices.getVertexCount() / 6; }
+
+    // A part of the texture stretched over dest, multiplied by color
+    void addTexturedRect(const sf::FloatRect& dest, const sf::IntRect& source,
+                         const sf::Color& color = sf::Color::White);
+    void addRect(const sf::FloatRect& dest, const sf::Color& color);
+
+    // A frame of the given thickness around (outside) rect, like a shape's outline
+    void addOutline(const sf::FloatRect& rect, float thickness, const sf::Color& color);
+
+    void draw(sf::RenderTarget& target) const;
+
+private:
+    sf::VertexArray vertices;
+    const sf::Texture* texture = nullptr;
+    sf::Vector2f solidTexCoord;
+
+    void appendRect(const sf::FloatRect& dest, const sf::FloatRect& tex, const sf::Color& color);
+};
+
+#endif // SPRITE_BATCH_H
@@ -0,0 +1,59 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer and one consumer thread
+ *
+ * A ring of Capacity slots (a power of two) with a write index owned by the
+ * producer and a read index owned by the consumer. Each side only loads the
+ * other's index, so push and pop never block or allocate and neither thread
+ * can stall the other; the release store of an index publishes the slot it
+ * covers. The indices live on separate cache lines so the two threads do not
+ * fight over one.
+ */
+template <typename T, std::size_t Capacity>
+class SPSCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer only. False (and value untouched) when the queue is full.
+    bool push(T&& value) {
+        const std::size_t write = writeIndex.load(std::memory_order_relaxed);
+        if (write - readIndex.load(std::memory_order_acquire) == Capacity) return false;
+        slots[write & (Capacity - 1)] = std::move(value);
+        writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& value) {
+        T copy(value);
+        return push(std::move(copy));
+    }
+
+    // Consumer only. False when the queue is empty.
+    bool pop(T& value) {
+        const std::size_t read = readIndex.load(std::memory_order_relaxed);
+        if (read == writeIndex.load(std::memory_order_acquire)) return false;
+        value = std::move(slots[read & (Capacity - 1)]);
+        readIndex.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side; only a snapshot while the other side is running
+    bool empty() const {
+        return readIndex.load(std::memory_order_acquire) == writeIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    alignas(CACHE_LINE) std::atomic<std::size_t> writeIndex{0};
+    alignas(CACHE_LINE) std::atomic<std::size_t> readIndex{0};
+    alignas(CACHE_LINE) T slots[Capacity];
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,1069 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include "syzygy.h"
+#include "movegen.h"
+#include "mapped_file.h"
+#include "search.h"
+#include "evaluate.h"
+
+// Probing code for the Syzygy tablebase format by Ronald de Man. Tables are
+// mapped read-only and never written, so after the one-time setup of a
+// table (under a lock) any number of search threads can probe it at once.
+
+namespace {
+
+// Table pieces use their own codes: 1..6 for white pawn..king (pawn, knight,
+// bishop, rook, queen, king), +8 for black
+constexpr int TB_TYPE[PIECE_TYPE_COUNT] = {1, 4, 2, 3, 5, 6}; // By our PieceType
+constexpr PieceType TB_PIECE_TYPE[7] = {
+    PieceType::PAWN, PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP,
+    PieceType::ROOK, PieceType::QUEEN, PieceType::KING
+};
+constexpr const char* TB_PIECE_CHARS = " PNBRQK";
+constexpr int TB_PAWN = 1;
+constexpr int TB_KING = 6;
+
+int tbPiece(PieceType type, PieceColor color) {
+    return TB_TYPE[static_cast<int>(type)] + (color == PieceColor::BLACK ? 8 : 0);
+}
+
+// Flags of one sub-table
+enum TableFlag {
+    FLAG_STM = 1, FLAG_MAPPED = 2, FLAG_WIN_PLIES = 4, FLAG_LOSS_PLIES = 8, FLAG_WIDE = 16,
+    FLAG_SINGLE_VALUE = 128
+};
+
+enum TableType { WDL, DTZ };
+
+constexpr unsigned char WDL_MAGIC[4] = {0x71, 0xE8, 0x23, 0x5D};
+constexpr unsigned char DTZ_MAGIC[4] = {0xD7, 0x66, 0x0C, 0xA5};
+
+// Files are little-endian except for the Huffman code stream
+inline std::uint16_t readLE16(const unsigned char* p) {
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+inline std::uint32_t readLE32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+inline std::uint32_t readBE32(const unsigned char* p) {
+    return (static_cast<std::uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+inline std::uint64_t readBE64(const unsigned char* p) {
+    return (static_cast<std::uint64_t>(readBE32(p)) << 32) | readBE32(p + 4);
+}
+
+// Index tables shared by every table, filled once by initIndexTables()
+int mapPawns[64];
+int mapB1H1H7[64];
+int mapA1D1D4[64];
+int mapKK[10][64];
+int binomial[6][64];        // [k][n]: ways to choose k squares out of n
+int leadPawnIdx[6][64];     // [lead pawn count][square]
+int leadPawnsSize[6][4];    // [lead pawn count][file a..d]
+
+// Rank minus file: negative below the a1-h8 diagonal, zero on it
+int offA1H8(int sq) { return rankOf(sq) - fileOf(sq); }
+
+bool pawnsComp(int a, int b) { return mapPawns[a] < mapPawns[b]; }
+
+int signOf(int value) { return (value > 0) - (value < 0); }
+
+// A capture or pawn move resets the fifty-move counter, and DTZ tables do not
+// store values for positions whose best move does so; this is the DTZ of the
+// position before such a move given its WDL result
+int dtzBeforeZeroing(WDLScore wdl) {
+    return wdl == WDL_WIN          ? 1
+         : wdl == WDL_CURSED_WIN   ? 101
+         : wdl == WDL_BLESSED_LOSS ? -101
+         : wdl == WDL_LOSS         ? -1 : 0;
+}
+
+// Material signature: four bits per piece count for the five non-king types of each color
+Key materialKey(const Position& pos, bool swapColors) {
+    Key key = 0;
+    for (int c = 0; c < COLOR_COUNT; ++c) {
+        const PieceColor color = static_cast<PieceColor>(c);
+        const int slot = swapColors ? 1 - c : c;
+        for (int t = 0; t < PIECE_TYPE_COUNT; ++t) {
+            const PieceType type = static_cast<PieceType>(t);
+            if (type == PieceType::KING) continue;
+            const Key count = static_cast<Key>(popCount(pos.pieces(color, type)));
+            key |= count << (4 * (slot * 5 + TB_TYPE[t] - 1));
+        }
+    }
+    return key;
+}
+
+// Same signature from a table name like "KRPvKR", the first side being white
+Key materialKey(const std::string& code, bool swapColors) {
+    Key key = 0;
+    int slot = swapColors ? 1 : 0;
+    for (char ch : code) {
+        if (ch == 'v') {
+            slot = 1 - slot;
+            continue;
+        }
+        const int type = static_cast<int>(std::strchr(TB_PIECE_CHARS, ch) - TB_PIECE_CHARS);
+        if (type != TB_KING) key += Key(1) << (4 * (slot * 5 + type - 1));
+    }
+    return key;
+}
+
+// Symbol of the Huffman-coded, recursively paired value stream
+using Sym = std::uint16_t;
+
+// Decoding data of one sub-table (per side to move and, with pawns, per lead pawn file)
+struct PairsData {
+    std::uint8_t flags = 0;
+    std::size_t sizeofBlock = 0;        // Block size in bytes
+    std::size_t span = 0;               // Values between two sparse index entries
+    int numBlocks = 0;
+    int maxSymLen = 0;
+    int minSymLen = 0;                  // Or the value itself for single-value tables
+    const unsigned char* lowestSym = nullptr;   // Lowest symbol of each code length, LE16
+    const unsigned char* btree = nullptr;       // 3 bytes per symbol: left and right child
+    const unsigned char* blockLength = nullptr; // Values per block minus one, LE16
+    int blockLengthSize = 0;
+    const unsigned char* sparseIndex = nullptr; // 6 bytes per entry: LE32 block, LE16 offset
+    std::size_t sparseIndexSize = 0;
+    const unsigned char* data = nullptr;        // Start of the compressed blocks
+    std::vector<std::uint64_t> base64;  // Lowest code of each length, left-aligned in 64 bits
+    std::vector<std::uint8_t> symlen;   // Values (minus one) a symbol expands to
+    int pieces[TB_MAX_PIECES] = {};     // Piece order used by the index
+    std::uint64_t groupIdx[TB_MAX_PIECES + 1] = {};
+    int groupLen[TB_MAX_PIECES + 1] = {};
+    std::uint16_t mapIdx[4] = {};       // DTZ value maps for win, loss, cursed win, blessed loss
+
+    Sym left(Sym sym) const {
+        const unsigned char* node = btree + 3 * sym;
+        return static_cast<Sym>(((node[1] & 0xF) << 8) | node[0]);
+    }
+    Sym right(Sym sym) const {
+        const unsigned char* node = btree + 3 * sym;
+        return static_cast<Sym>((node[2] << 4) | (node[1] >> 4));
+    }
+};
+
+// One .rtbw or .rtbz file. The material data is filled when the tables are
+// registered; the file is mapped and the PairsData set up on first use.
+struct Table {
+    TableType type;
+    std::atomic<bool> ready{false};
+    MappedFile file;
+    const unsigned char* map = nullptr; // DTZ value maps
+    Key key = 0;                        // Material with the table's first side as white
+    Key key2 = 0;                       // ... and as black
+    int pieceCount = 0;
+    bool hasPawns = false;
+    bool hasUniquePieces = false;
+    std::uint8_t pawnCount[2] = {};     // [lead color, other color]
+    PairsData items[2][4];              // [side to move][lead pawn file a..d, or 0]
+
+    int sides() const { return type == WDL ? 2 : 1; }
+    PairsData* get(int stm, int file) { return &items[stm % sides()][hasPawns ? file : 0]; }
+};
+
+// Registered tables, looked up by material signature
+class TableRegistry {
+public:
+    void clear() {
+        for (Entry& entry : hashTable) entry = Entry();
+        wdlTables.clear();
+        dtzTables.clear();
+        maxPieces = 0;
+    }
+
+    // Registers the table for a piece list like "KRPvKR" if its .rtbw file exists
+    void add(const std::string& code);
+
+    Table* get(Key key, TableType type) {
+        for (const Entry* entry = &hashTable[bucketOf(key)];; ++entry) {
+            if (!entry->wdl) return nullptr;
+            if (entry->key == key) return type == WDL ? entry->wdl : entry->dtz;
+        }
+    }
+
+    int size() const { return static_cast<int>(wdlTables.size()); }
+    int maxPieces = 0;
+
+private:
+    // Enough for all 5-, 6- and 7-piece tables, twice (one entry per color arrangement)
+    static constexpr int SIZE = 1 << 13;
+    static constexpr int OVERFLOW_SLOTS = 1;
+
+    struct Entry {
+        Key key = 0;
+        Table* wdl = nullptr;
+        Table* dtz = nullptr;
+    };
+
+    Entry hashTable[SIZE + OVERFLOW_SLOTS];
+    std::deque<Table> wdlTables;    // A deque never moves its elements
+    std::deque<Table> dtzTables;
+
+    // Material keys are packed counts, so mix them before taking a bucket
+    static std::uint32_t bucketOf(Key key) {
+        return static_cast<std::uint32_t>((key * 0x9E3779B97F4A7C15ULL) >> 51) & (SIZE - 1);
+    }
+
+    void insert(Key key, Table* wdl, Table* dtz);
+};
+
+TableRegistry registry;
+std::string tablePaths;
+TablebaseConfig config;
+
+// Opens name in the first of the tablebase directories that has it
+bool findTableFile(const std::string& name, std::string& path) {
+#ifdef _WIN32
+    constexpr char SEPARATOR = ';';
+#else
+    constexpr char SEPARATOR = ':';
+#endif
+    std::size_t start = 0;
+    while (start <= tablePaths.size()) {
+        std::size_t end = tablePaths.find(SEPARATOR, start);
+        if (end == std::string::npos) end = tablePaths.size();
+        const std::string dir = tablePaths.substr(start, end - start);
+        start = end + 1;
+        if (dir.empty()) continue;
+
+        const std::string candidate = dir + "/" + name;
+        if (std::ifstream(candidate).good()) {
+            path = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TableRegistry::insert(Key key, Table* wdl, Table* dtz) {
+    std::uint32_t home = bucketOf(key);
+    Entry entry{key, wdl, dtz};
+
+    // Robin Hood hashing: an entry far from its home bucket takes the slot of
+    // one closer to its own. The last slot stays empty to end every lookup.
+    for (std::uint32_t bucket = home; bucket < SIZE + OVERFLOW_SLOTS - 1; ++bucket) {
+        const Key otherKey = hashTable[bucket].key;
+        if (otherKey == entry.key || !hashTable[bucket].wdl) {
+            hashTable[bucket] = entry;
+            return;
+        }
+        const std::uint32_t otherHome = bucketOf(otherKey);
+        if (otherHome > home) {
+            std::swap(entry, hashTable[bucket]);
+            home = otherHome;
+        }
+    }
+    std::cerr << "Warning: Tablebase hash table full, " << entry.key << " not registered" << std::endl;
+}
+
+void TableRegistry::add(const std::string& code) {
+    std::string path;
+    if (!findTableFile(code + ".rtbw", path)) return;
+
+    wdlTables.emplace_back();
+    Table& wdl = wdlTables.back();
+    wdl.type = WDL;
+    wdl.key = materialKey(code, false);
+    wdl.key2 = materialKey(code, true);
+
+    int counts[2][7] = {};
+    int side = 0;
+    for (char ch : code) {
+        if (ch == 'v') {
+            side = 1;
+            continue;
+        }
+        counts[side][std::strchr(TB_PIECE_CHARS, ch) - TB_PIECE_CHARS]++;
+        wdl.pieceCount++;
+    }
+    wdl.hasPawns = counts[0][TB_PAWN] + counts[1][TB_PAWN] > 0;
+    for (int c = 0; c < 2; ++c) {
+        for (int t = TB_PAWN; t < TB_KING; ++t) {
+            if (counts[c][t] == 1) wdl.hasUniquePieces = true;
+        }
+    }
+
+    // The lead color is the one with fewer pawns (but some), which compresses better
+    const bool whiteLeads = !counts[1][TB_PAWN] ||
+                            (counts[0][TB_PAWN] && counts[1][TB_PAWN] >= counts[0][TB_PAWN]);
+    wdl.pawnCount[0] = static_cast<std::uint8_t>(counts[whiteLeads ? 0 : 1][TB_PAWN]);
+    wdl.pawnCount[1] = static_cast<std::uint8_t>(counts[whiteLeads ? 1 : 0][TB_PAWN]);
+
+    dtzTables.emplace_back();
+    Table& dtz = dtzTables.back();
+    dtz.type = DTZ;
+    dtz.key = wdl.key;
+    dtz.key2 = wdl.key2;
+    dtz.pieceCount = wdl.pieceCount;
+    dtz.hasPawns = wdl.hasPawns;
+    dtz.hasUniquePieces = wdl.hasUniquePieces;
+    dtz.pawnCount[0] = wdl.pawnCount[0];
+    dtz.pawnCount[1] = wdl.pawnCount[1];
+
+    maxPieces = std::max(maxPieces, wdl.pieceCount);
+
+    // The same table serves both color arrangements: KRvK and KvKR
+    insert(wdl.key, &wdl, &dtz);
+    insert(wdl.key2, &wdl, &dtz);
+}
+
+// Groups of pieces are encoded together: usually pieces of the same type
+// and color, except for the leading group, which is the lead pawns or, without
+// pawns, three unique pieces (or the two kings). Computes each group's size
+// and the factor its index is multiplied by.
+void setGroups(Table& e, PairsData* d, const int order[2], int file) {
+    int n = 0;
+    int firstLen = e.hasPawns ? 0 : (e.hasUniquePieces ? 3 : 2);
+    d->groupLen[n] = 1;
+
+    for (int i = 1; i < e.pieceCount; ++i) {
+        if (--firstLen > 0 || d->pieces[i] == d->pieces[i - 1]) {
+            d->groupLen[n]++;
+        } else {
+            d->groupLen[++n] = 1;
+        }
+    }
+    d->groupLen[++n] = 0;
+
+    // The order the groups are multiplied in is stored per table: the
+    // leading group at order[0] and the remaining pawns at order[1]
+    const bool pawnsOnBothSides = e.hasPawns && e.pawnCount[1];
+    int next = pawnsOnBothSides ? 2 : 1;
+    int freeSquares = 64 - d->groupLen[0] - (pawnsOnBothSides ? d->groupLen[1] : 0);
+    std::uint64_t idx = 1;
+
+    for (int k = 0; next < n || k == order[0] || k == order[1]; ++k) {
+        if (k == order[0]) {
+            d->groupIdx[0] = idx;
+            idx *= e.hasPawns ? leadPawnsSize[d->groupLen[0]][file] : (e.hasUniquePieces ? 31332 : 462);
+        } else if (k == order[1]) {
+            d->groupIdx[1] = idx;
+            idx *= binomial[d->groupLen[1]][48 - d->groupLen[0]];
+        } else {
+            d->groupIdx[next] = idx;
+            idx *= binomial[d->groupLen[next]][freeSquares];
+            freeSquares -= d->groupLen[next++];
+        }
+    }
+    d->groupIdx[n] = idx;
+}
+
+// Number of values (minus one) a paired symbol expands to
+std::uint8_t setSymlen(PairsData* d, Sym sym, std::vector<bool>& visited) {
+    visited[sym] = true;
+    const Sym right = d->right(sym);
+    if (right == 0xFFF) return 0;
+
+    const Sym left = d->left(sym);
+    if (!visited[left]) d->symlen[left] = setSymlen(d, left, visited);
+    if (!visited[right]) d->symlen[right] = setSymlen(d, right, visited);
+    return static_cast<std::uint8_t>(d->symlen[left] + d->symlen[right] + 1);
+}
+
+const unsigned char* setSizes(PairsData* d, const unsigned char* data) {
+    d->flags = *data++;
+
+    if (d->flags & FLAG_SINGLE_VALUE) {
+        d->numBlocks = 0;
+        d->span = 0;
+        d->blockLengthSize = 0;
+        d->sparseIndexSize = 0;
+        d->minSymLen = *data++;
+        return data;
+    }
+
+    // The last group factor is the number of positions in the table
+    int groups = 0;
+    while (groups < TB_MAX_PIECES && d->groupLen[groups]) ++groups;
+    const std::uint64_t tableSize = d->groupIdx[groups];
+
+    d->sizeofBlock = std::size_t(1) << *data++;
+    d->span = std::size_t(1) << *data++;
+    d->sparseIndexSize = static_cast<std::size_t>((tableSize + d->span - 1) / d->span);
+    const int padding = *data++;
+    d->numBlocks = static_cast<int>(readLE32(data));
+    data += 4;
+    d->blockLengthSize = d->numBlocks + padding;
+    d->maxSymLen = *data++;
+    d->minSymLen = *data++;
+    d->lowestSym = data;
+    d->base64.assign(d->maxSymLen - d->minSymLen + 1, 0);
+
+    // Canonical Huffman code: longer codes have lower values, so each length's
+    // lowest code follows from the next length's
+    for (int i = static_cast<int>(d->base64.size()) - 2; i >= 0; --i) {
+        d->base64[i] = (d->base64[i + 1] + readLE16(d->lowestSym + 2 * i) -
+                        readLE16(d->lowestSym + 2 * (i + 1))) / 2;
+    }
+    for (std::size_t i = 0; i < d->base64.size(); ++i) {
+        d->base64[i] <<= 64 - i - d->minSymLen;
+    }
+
+    data += d->base64.size() * sizeof(Sym);
+    d->symlen.assign(readLE16(data), 0);
+    data += 2;
+    d->btree = data;
+
+    std::vector<bool> visited(d->symlen.size());
+    for (std::size_t sym = 0; sym < d->symlen.size(); ++sym) {
+        if (!visited[sym]) d->symlen[sym] = setSymlen(d, static_cast<Sym>(sym), visited);
+    }
+    return data + d->symlen.size() * 3 + (d->symlen.size() & 1);
+}
+
+const unsigned char* alignTo(const unsigned char* data, const unsigned char* base, std::size_t alignment) {
+    const std::size_t offset = static_cast<std::size_t>(data - base);
+    return base + (offset + alignment - 1) / alignment * alignment;
+}
+
+const unsigned char* setDtzMap(Table& e, const unsigned char* data, const unsigned char* base, int maxFile) {
+    e.map = data;
+    for (int f = 0; f <= maxFile; ++f) {
+        PairsData* d = e.get(0, f);
+        if (!(d->flags & FLAG_MAPPED)) continue;
+
+        if (d->flags & FLAG_WIDE) {
+            data = alignTo(data, base, 2);
+            for (int i = 0; i < 4; ++i) {
+                d->mapIdx[i] = static_cast<std::uint16_t>((data - e.map) / 2 + 1);
+                data += 2 * readLE16(data) + 2;
+            }
+        } else {
+            for (int i = 0; i < 4; ++i) {
+                d->mapIdx[i] = static_cast<std::uint16_t>(data - e.map + 1);
+                data += *data + 1;
+            }
+        }
+    }
+    return alignTo(data, base, 2);
+}
+
+// Reads the layout of a freshly mapped file into the table's PairsData
+void setupTable(Table& e, const unsigned char* base) {
+    const unsigned char* data = base + 4; // Past the magic
+    data++; // Split and pawn flags, known from the material already
+
+    const int sides = (e.sides() == 2 && e.key != e.key2) ? 2 : 1;
+    const int maxFile = e.hasPawns ? 3 : 0;
+    const bool pawnsOnBothSides = e.hasPawns && e.pawnCount[1];
+
+    for (int f = 0; f <= maxFile; ++f) {
+        for (int i = 0; i < sides; ++i) *e.get(i, f) = PairsData();
+
+        const int order[2][2] = {
+            {*data & 0xF, pawnsOnBothSides ? *(data + 1) & 0xF : 0xF},
+            {*data >> 4, pawnsOnBothSides ? *(data + 1) >> 4 : 0xF}
+        };
+        data += 1 + pawnsOnBothSides;
+
+        for (int k = 0; k < e.pieceCount; ++k, ++data) {
+            for (int i = 0; i < sides; ++i) {
+                e.get(i, f)->pieces[k] = i ? *data >> 4 : *data & 0xF;
+            }
+        }
+        for (int i = 0; i < sides; ++i) setGroups(e, e.get(i, f), order[i], f);
+    }
+
+    data = alignTo(data, base, 2);
+
+    for (int f = 0; f <= maxFile; ++f) {
+        for (int i = 0; i < sides; ++i) data = setSizes(e.get(i, f), data);
+    }
+
+    if (e.type == DTZ) data = setDtzMap(e, data, base, maxFile);
+
+    for (int f = 0; f <= maxFile; ++f) {
+        for (int i = 0; i < sides; ++i) {
+            PairsData* d = e.get(i, f);
+            d->sparseIndex = data;
+            data += d->sparseIndexSize * 6;
+        }
+    }
+    for (int f = 0; f <= maxFile; ++f) {
+        for (int i = 0; i < sides; ++i) {
+            PairsData* d = e.get(i, f);
+            d->blockLength = data;
+            data += d->blockLengthSize * 2;
+        }
+    }
+    for (int f = 0; f <= maxFile; ++f) {
+        for (int i = 0; i < sides; ++i) {
+            PairsData* d = e.get(i, f);
+            data = alignTo(data, base, 64);
+            d->data = data;
+            data += static_cast<std::size_t>(d->numBlocks) * d->sizeofBlock;
+        }
+    }
+}
+
+// Maps the table's file on first use; false if it is missing or corrupt.
+// Safe to call from several threads at once.
+bool ensureMapped(Table& e, const Position& pos) {
+    static std::mutex mutex;
+
+    if (e.ready.load(std::memory_order_acquire)) return e.file.isOpen();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (e.ready.load(std::memory_order_relaxed)) return e.file.isOpen();
+
+    // File name: the pieces of each side from king to pawn, stronger side first
+    std::string white, black;
+    for (int t = TB_KING; t >= TB_PAWN; --t) {
+        white += std::string(popCount(pos.pieces(PieceColor::WHITE, TB_PIECE_TYPE[t])), TB_PIECE_CHARS[t]);
+        black += std::string(popCount(pos.pieces(PieceColor::BLACK, TB_PIECE_TYPE[t])), TB_PIECE_CHARS[t]);
+    }
+    const std::string name = (e.key == materialKey(pos, false) ? white + 'v' + black : black + 'v' + white) +
+                             (e.type == WDL ? ".rtbw" : ".rtbz");
+
+    std::string path;
+    if (findTableFile(name, path) && e.file.open(path, true)) {
+        const unsigned char* magic = e.type == WDL ? WDL_MAGIC : DTZ_MAGIC;
+        if (e.file.size() % 64 != 16 || std::memcmp(e.file.data(), magic, 4) != 0) {
+            std::cerr << "Warning: Corrupted tablebase file " << path << std::endl;
+            e.file.close();
+        } else {
+            setupTable(e, e.file.data());
+        }
+    }
+
+    e.ready.store(true, std::memory_order_release);
+    return e.file.isOpen();
+}
+
+// Decodes the value with index idx. Blocks hold a variable number of
+// Huffman-coded symbols, each expanding to one or more values; the sparse
+// index points close to the block holding any given index.
+int decompressPairs(const PairsData* d, std::uint64_t idx) {
+    if (d->flags & FLAG_SINGLE_VALUE) return d->minSymLen;
+
+    // Sparse entry k describes the value at index k * span + span / 2
+    const std::uint32_t k = static_cast<std::uint32_t>(idx / d->span);
+    std::uint32_t block = readLE32(d->sparseIndex + 6 * k);
+    int offset = readLE16(d->sparseIndex + 6 * k + 4);
+    offset += static_cast<int>(idx % d->span) - static_cast<int>(d->span / 2);
+
+    // Walk to the block that really holds our value
+    while (offset < 0) offset += readLE16(d->blockLength + 2 * --block) + 1;
+    while (offset > readLE16(d->blockLength + 2 * block)) offset -= readLE16(d->blockLength + 2 * block++) + 1;
+
+    const unsigned char* ptr = d->data + static_cast<std::uint64_t>(block) * d->sizeofBlock;
+    std::uint64_t buf64 = readBE64(ptr);
+    ptr += 8;
+    int buf64Size = 64;
+    Sym sym;
+
+    for (;;) {
+        // Code length from the left-aligned lowest code of each length
+        int len = 0;
+        while (buf64 < d->base64[len]) ++len;
+
+        sym = static_cast<Sym>((buf64 - d->base64[len]) >> (64 - len - d->minSymLen));
+        sym = static_cast<Sym>(sym + readLE16(d->lowestSym + 2 * len));
+
+        if (offset < d->symlen[sym] + 1) break;
+
+        offset -= d->symlen[sym] + 1;
+        len += d->minSymLen;
+        buf64 <<= len;
+        buf64Size -= len;
+        if (buf64Size <= 32) {
+            buf64Size += 32;
+            buf64 |= static_cast<std::uint64_t>(readBE32(ptr)) << (64 - buf64Size);
+            ptr += 4;
+        }
+    }
+
+    // Expand the pair tree down to the single value we want
+    while (d->symlen[sym]) {
+        const Sym left = d->left(sym);
+        if (offset < d->symlen[left] + 1) {
+            sym = left;
+        } else {
+            offset -= d->symlen[left] + 1;
+            sym = d->right(sym);
+        }
+    }
+    return d->left(sym);
+}
+
+// DTZ tables are one-sided: they may store only the other side to move
+bool dtzHasSide(Table& e, int stm, int file) {
+    if (e.type == WDL) return true;
+    const int flags = e.get(stm, file)->flags;
+    return (flags & FLAG_STM) == stm || (e.key == e.key2 && !e.hasPawns);
+}
+
+// Stored DTZ values are ranked by frequency per WDL result; the map turns
+// them back into distances, in plies
+int mapScore(Table& e, int file, int value, WDLScore wdl) {
+    if (e.type == WDL) return value - 2;
+
+    constexpr int WDL_MAP[] = {1, 3, 0, 2, 0};
+    const PairsData* d = e.get(0, file);
+    const int flags = d->flags;
+
+    if (flags & FLAG_MAPPED) {
+        const int index = d->mapIdx[WDL_MAP[wdl + 2]] + value;
+        value = (flags & FLAG_WIDE) ? readLE16(e.map + 2 * index) : e.map[index];
+    }
+
+    if ((wdl == WDL_WIN && !(flags & FLAG_WIN_PLIES)) ||
+        (wdl == WDL_LOSS && !(flags & FLAG_LOSS_PLIES)) ||
+        wdl == WDL_CURSED_WIN || wdl == WDL_BLESSED_LOSS) {
+        value *= 2;
+    }
+    return value + 1;
+}
+
+// Computes the position's index in the table and decodes its value. Tables
+// are stored with the stronger side as white and pieces normalized by
+// symmetry, so colors and squares are flipped to match first.
+int probeTable(const Position& pos, Table& e, WDLScore wdl, ProbeState& result) {
+    int squares[TB_MAX_PIECES];
+    int pieces[TB_MAX_PIECES];
+    std::uint64_t idx;
+    int size = 0;
+    int leadPawnsCount = 0;
+    Bitboard b;
+    Bitboard leadPawns = 0;
+    int tbFile = 0;
+
+    const int stmBlack = pos.sideToMove() == PieceColor::BLACK ? 1 : 0;
+    const bool symmetricBlackToMove = e.key == e.key2 && stmBlack;
+    const bool blackStronger = materialKey(pos, false) != e.key;
+    const bool flip = symmetricBlackToMove || blackStronger;
+    const int flipColor = flip ? 8 : 0;
+    const int flipSquares = flip ? 56 : 0;
+    const int stm = (flip ? 1 : 0) ^ stmBlack;
+
+    // With pawns the table is split by the file of the lead pawn: the one
+    // nearest the edge and, among those, on the lowest rank
+    if (e.hasPawns) {
+        const int leadPiece = e.get(0, 0)->pieces[0] ^ flipColor;
+        const PieceColor leadColor = leadPiece >= 8 ? PieceColor::BLACK : PieceColor::WHITE;
+        leadPawns = b = pos.pieces(leadColor, PieceType::PAWN);
+        do {
+            squares[size++] = popLsb(b) ^ flipSquares;
+        } while (b);
+        leadPawnsCount = size;
+
+        std::swap(squares[0], *std::max_element(squares, squares + leadPawnsCount, pawnsComp));
+        tbFile = std::min(fileOf(squares[0]), 7 - fileOf(squares[0]));
+    }
+
+    if (!dtzHasSide(e, stm, tbFile)) {
+        result = PROBE_CHANGE_STM;
+        return 0;
+    }
+
+    b = pos.pieces() ^ leadPawns;
+    do {
+        const int sq = popLsb(b);
+        PieceType type;
+        PieceColor color;
+        pos.pieceAt(sq, type, color);
+        squares[size] = sq ^ flipSquares;
+        pieces[size++] = tbPiece(type, color) ^ flipColor;
+    } while (b);
+
+    PairsData* d = e.get(stm, tbFile);
+
+    // Put the pieces in the table's order
+    for (int i = leadPawnsCount; i < size - 1; ++i) {
+        for (int j = i + 1; j < size; ++j) {
+            if (d->pieces[i] == pieces[j]) {
+                std::swap(pieces[i], pieces[j]);
+                std::swap(squares[i], squares[j]);
+                break;
+            }
+        }
+    }
+
+    // Mirror so the leading piece is on files a-d
+    if (fileOf(squares[0]) > 3) {
+        for (int i = 0; i < size; ++i) squares[i] ^= 7;
+    }
+
+    if (e.hasPawns) {
+        idx = leadPawnIdx[leadPawnsCount][squares[0]];
+        std::stable_sort(squares + 1, squares + leadPawnsCount, pawnsComp);
+        for (int i = 1; i < leadPawnsCount; ++i) idx += binomial[i][mapPawns[squares[i]]];
+    } else {
+        // Without pawns also mirror to ranks 1-4, then below the a1-h8 diagonal
+        if (rankOf(squares[0]) > 3) {
+            for (int i = 0; i < size; ++i) squares[i] ^= 56;
+        }
+        for (int i = 0; i < d->groupLen[0]; ++i) {
+            if (!offA1H8(squares[i])) continue;
+            if (offA1H8(squares[i]) > 0) {
+                for (int j = i; j < size; ++j) squares[j] = ((squares[j] >> 3) | (squares[j] << 3)) & 63;
+            }
+            break;
+        }
+
+        // Three unique pieces are encoded together (31332 combinations),
+        // otherwise just the two kings (462)
+        if (e.hasUniquePieces) {
+            const int adjust1 = squares[1] > squares[0];
+            const int adjust2 = (squares[2] > squares[0]) + (squares[2] > squares[1]);
+
+            if (offA1H8(squares[0])) {
+                idx = (mapA1D1D4[squares[0]] * 63 + (squares[1] - adjust1)) * 62 + squares[2] - adjust2;
+            } else if (offA1H8(squares[1])) {
+                idx = (6 * 63 + rankOf(squares[0]) * 28 + mapB1H1H7[squares[1]]) * 62 + squares[2] - adjust2;
+            } else if (offA1H8(squares[2])) {
+                idx = 6 * 63 * 62 + 4 * 28 * 62 + rankOf(squares[0]) * 7 * 28 +
+                      (rankOf(squares[1]) - adjust1) * 28 + mapB1H1H7[squares[2]];
+            } else {
+                idx = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + rankOf(squares[0]) * 7 * 6 +
+                      (rankOf(squares[1]) - adjust1) * 6 + (rankOf(squares[2]) - adjust2);
+            }
+        } else {
+            idx = mapKK[mapA1D1D4[squares[0]]][squares[1]];
+        }
+    }
+
+    // The remaining groups: each a combination of squares not taken by earlier groups
+    idx *= d->groupIdx[0];
+    int* groupSq = squares + d->groupLen[0];
+    bool remainingPawns = e.hasPawns && e.pawnCount[1];
+
+    for (int next = 1; d->groupLen[next]; ++next) {
+        std::stable_sort(groupSq, groupSq + d->groupLen[next]);
+        std::uint64_t n = 0;
+        for (int i = 0; i < d->groupLen[next]; ++i) {
+            const int below = static_cast<int>(std::count_if(squares, groupSq, [&](int sq) { return groupSq[i] > sq; }));
+            n += binomial[i + 1][groupSq[i] - below - 8 * remainingPawns];
+        }
+        remainingPawns = false;
+        idx += n * d->groupIdx[next];
+        groupSq += d->groupLen[next];
+    }
+
+    return mapScore(e, tbFile, decompressPairs(d, idx), wdl);
+}
+
+// Probes the table for the position's material (KvK is always a draw)
+int probeMaterial(const Position& pos, TableType type, ProbeState& result, WDLScore wdl = WDL_DRAW) {
+    if (popCount(pos.pieces()) == 2) return WDL_DRAW;
+
+    Table* entry = registry.get(materialKey(pos, false), type);
+    if (!entry || !ensureMapped(*entry, pos)) {
+        result = PROBE_FAIL;
+        return 0;
+    }
+    return probeTable(pos, *entry, wdl, result);
+}
+
+bool isZeroing(const Position& pos, Move move) {
+    return isCapture(move) || pos.typeOn(moveFrom(move)) == PieceType::PAWN;
+}
+
+// Tables store "don't care" values where a capture (or, for DTZ, any zeroing
+// move) decides the result, and ignore en passant, so the captures are
+// searched and the best of them and the stored value is the true value
+WDLScore searchZeroing(Position& pos, ProbeState& result, bool checkZeroingMoves) {
+    WDLScore bestValue = WDL_LOSS;
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    int zeroingCount = 0;
+
+    UndoInfo undo;
+    for (Move move : moves) {
+        if (!isCapture(move) && (!checkZeroingMoves || pos.typeOn(moveFrom(move)) != PieceType::PAWN)) continue;
+        zeroingCount++;
+
+        pos.makeMove(move, undo);
+        const WDLScore value = static_cast<WDLScore>(-searchZeroing(pos, result, false));
+        pos.unmakeMove(move, undo);
+
+        if (result == PROBE_FAIL) return WDL_DRAW;
+
+        if (value > bestValue) {
+            bestValue = value;
+            if (value >= WDL_WIN) {
+                result = PROBE_ZEROING_BEST_MOVE;
+                return value;
+            }
+        }
+    }
+
+    // With every legal move searched the stored value is not needed (and may be wrong)
+    const bool noMoreMoves = zeroingCount && zeroingCount == moves.count;
+    WDLScore value;
+    if (noMoreMoves) {
+        value = bestValue;
+    } else {
+        value = static_cast<WDLScore>(probeMaterial(pos, WDL, result));
+        if (result == PROBE_FAIL) return WDL_DRAW;
+    }
+
+    if (bestValue >= value) {
+        result = (bestValue > WDL_DRAW || noMoreMoves) ? PROBE_ZEROING_BEST_MOVE : PROBE_OK;
+        return bestValue;
+    }
+    result = PROBE_OK;
+    return value;
+}
+
+void initIndexTables() {
+    // b1..h7 below the a1-h8 diagonal to 0..27
+    int code = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        if (offA1H8(sq) < 0) mapB1H1H7[sq] = code++;
+    }
+
+    // The a1-d1-d4 triangle to 0..9, diagonal squares last
+    std::vector<int> diagonal;
+    code = 0;
+    for (int sq = 0; sq <= 27; ++sq) {
+        if (offA1H8(sq) < 0 && fileOf(sq) <= 3) {
+            mapA1D1D4[sq] = code++;
+        } else if (!offA1H8(sq) && fileOf(sq) <= 3) {
+            diagonal.push_back(sq);
+        }
+    }
+    for (int sq : diagonal) mapA1D1D4[sq] = code++;
+
+    // The 462 legal placements of two kings with the first in the triangle;
+    // with the first on the diagonal the second may not be above it
+    std::vector<std::pair<int, int>> bothOnDiagonal;
+    code = 0;
+    for (int idx = 0; idx < 10; ++idx) {
+        for (int s1 = 0; s1 <= 27; ++s1) {
+            if (mapA1D1D4[s1] != idx || (!idx && s1 != 1)) continue; // b1 is mapped to 0
+            for (int s2 = 0; s2 < 64; ++s2) {
+                if ((kingAttacks(s1) | squareBB(s1)) & squareBB(s2)) continue;
+                if (!offA1H8(s1) && offA1H8(s2) > 0) continue;
+                if (!offA1H8(s1) && !offA1H8(s2)) {
+                    bothOnDiagonal.emplace_back(idx, s2);
+                } else {
+                    mapKK[idx][s2] = code++;
+                }
+            }
+        }
+    }
+    for (const auto& kings : bothOnDiagonal) mapKK[kings.first][kings.second] = code++;
+
+    // Pascal's triangle
+    binomial[0][0] = 1;
+    for (int n = 1; n < 64; ++n) {
+        for (int k = 0; k < 6 && k <= n; ++k) {
+            binomial[k][n] = (k > 0 ? binomial[k - 1][n - 1] : 0) + (k < n ? binomial[k][n - 1] : 0);
+        }
+    }
+
+    // a2..h7 to 47..0, edge files and low ranks highest; the lead pawn is the
+    // one with the highest value. Then the index offsets of each lead pawn square.
+    int availableSquares = 47;
+    for (int leadCount = 1; leadCount <= 5; ++leadCount) {
+        for (int file = 0; file < 4; ++file) {
+            int idx = 0;
+            for (int rank = 1; rank <= 6; ++rank) {
+                const int sq = makeSquare(file, rank);
+                if (leadCount == 1) {
+                    mapPawns[sq] = availableSquares--;
+                    mapPawns[sq ^ 7] = availableSquares--;
+                }
+                leadPawnIdx[leadCount][sq] = idx;
+                idx += binomial[leadCount - 1][mapPawns[sq]];
+            }
+            leadPawnsSize[leadCount][file] = idx;
+        }
+    }
+}
+
+std::string tableCode(const std::vector<int>& types) {
+    std::string code;
+    for (int type : types) code += TB_PIECE_CHARS[type];
+    code.insert(code.find('K', 1), "v");
+    return code;
+}
+
+} // namespace
+
+void setTablebaseConfig(const TablebaseConfig& newConfig) {
+    config = newConfig;
+}
+
+TablebaseConfig getTablebaseConfig() {
+    return config;
+}
+
+int tablebaseMaxPieces() {
+    return registry.maxPieces;
+}
+
+int initTablebases(const std::string& paths) {
+    static bool indexTablesReady = false;
+    if (!indexTablesReady) {
+        initIndexTables();
+        indexTablesReady = true;
+    }
+
+    registry.clear();
+    tablePaths = paths;
+    if (paths.empty() || paths == "<empty>") return 0;
+
+    // Every material combination up to seven pieces, each side's pieces in
+    // descending type order, the stronger side first (as the files are named)
+    const int K = TB_KING;
+    for (int p1 = TB_PAWN; p1 < K; ++p1) {
+        registry.add(tableCode({K, p1, K}));
+
+        for (int p2 = TB_PAWN; p2 <= p1; ++p2) {
+            registry.add(tableCode({K, p1, p2, K}));
+            registry.add(tableCode({K, p1, K, p2}));
+
+            for (int p3 = TB_PAWN; p3 < K; ++p3) registry.add(tableCode({K, p1, p2, K, p3}));
+
+            for (int p3 = TB_PAWN; p3 <= p2; ++p3) {
+                registry.add(tableCode({K, p1, p2, p3, K}));
+
+                for (int p4 = TB_PAWN; p4 <= p3; ++p4) {
+                    registry.add(tableCode({K, p1, p2, p3, p4, K}));
+                    for (int p5 = TB_PAWN; p5 <= p4; ++p5) registry.add(tableCode({K, p1, p2, p3, p4, p5, K}));
+                    for (int p5 = TB_PAWN; p5 < K; ++p5) registry.add(tableCode({K, p1, p2, p3, p4, K, p5}));
+                }
+                for (int p4 = TB_PAWN; p4 < K; ++p4) {
+                    registry.add(tableCode({K, p1, p2, p3, K, p4}));
+                    for (int p5 = TB_PAWN; p5 <= p4; ++p5) registry.add(tableCode({K, p1, p2, p3, K, p4, p5}));
+                }
+            }
+
+            for (int p3 = TB_PAWN; p3 <= p1; ++p3) {
+                for (int p4 = TB_PAWN; p4 <= (p1 == p3 ? p2 : p3); ++p4) {
+                    registry.add(tableCode({K, p1, p2, K, p3, p4}));
+                }
+            }
+        }
+    }
+    return registry.size();
+}
+
+WDLScore probeWDL(Position& pos, ProbeState& result) {
+    result = PROBE_OK;
+    return searchZeroing(pos, result, false);
+}
+
+int probeDTZ(Position& pos, ProbeState& result) {
+    result = PROBE_OK;
+    const WDLScore wdl = searchZeroing(pos, result, true);
+
+    // Draws are not stored
+    if (result == PROBE_FAIL || wdl == WDL_DRAW) return 0;
+
+    // The stored value is a "don't care" when a zeroing move is best
+    if (result == PROBE_ZEROING_BEST_MOVE) return dtzBeforeZeroing(wdl);
+
+    int dtz = probeMaterial(pos, DTZ, result, wdl);
+    if (result == PROBE_FAIL) return 0;
+
+    if (result != PROBE_CHANGE_STM) {
+        return (dtz + 100 * (wdl == WDL_BLESSED_LOSS || wdl == WDL_CURSED_WIN)) * signOf(wdl);
+    }
+
+    // Only the other side to move is stored: take the best move's DTZ, one ply on
+    int minDTZ = 0xFFFF;
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    UndoInfo undo;
+    for (Move move : moves) {
+        const bool zeroing = isZeroing(pos, move);
+        pos.makeMove(move, undo);
+
+        // After a zeroing move we want the DTZ before it, which only needs the WDL result
+        dtz = zeroing ? -dtzBeforeZeroing(searchZeroing(pos, result, false)) : -probeDTZ(pos, result);
+
+        // A mating move counts as one ply
+        if (dtz == 1 && pos.inCheck()) {
+            MoveList replies;
+            generateLegalMoves(pos, replies);
+            if (replies.empty()) minDTZ = 1;
+        }
+
+        if (!zeroing) dtz += signOf(dtz);
+        if (dtz < minDTZ && signOf(dtz) == signOf(wdl)) minDTZ = dtz;
+
+        pos.unmakeMove(move, undo);
+        if (result == PROBE_FAIL) return 0;
+    }
+    return minDTZ == 0xFFFF ? -1 : minDTZ;
+}
+
+bool probeRoot(Position& pos, const std::vector<Key>& history, std::vector<Move>& moves, int& score) {
+    constexpr int MAX_DTZ = 1 << 18;
+    const int halfmove = pos.halfmoveClock();
+
+    // Whether key occurs among the last plies game positions before the root
+    auto seenBefore = [&](Key key, int plies) {
+        const int count = static_cast<int>(history.size());
+        for (int back = 1; back <= plies && back <= count; ++back) {
+            if (history[count - back] == key) return true;
+        }
+        return false;
+    };
+
+    // Some position since the last capture or pawn move (the root included) has
+    // occurred twice: the game may not count on the fifty-move margin then
+    std::vector<Key> reversible(history.end() - std::min(halfmove, static_cast<int>(history.size())), history.end());
+    reversible.push_back(pos.hashKey());
+    std::sort(reversible.begin(), reversible.end());
+    const bool repeated = std::adjacent_find(reversible.begin(), reversible.end()) != reversible.end();
+
+    std::vector<int> ranks(moves.size());
+    ProbeState result = PROBE_OK;
+    UndoInfo undo;
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        pos.makeMove(moves[i], undo);
+
+        int dtz;
+        if (pos.halfmoveClock() == 0) {
+            dtz = dtzBeforeZeroing(static_cast<WDLScore>(-probeWDL(pos, result)));
+        } else if (pos.halfmoveClock() >= 100 || seenBefore(pos.hashKey(), pos.halfmoveClock() - 1)) {
+            // Draw by the fifty-move rule or by repeating a game position
+            dtz = 0;
+        } else {
+            dtz = -probeDTZ(pos, result);
+            dtz = dtz > 0 ? dtz + 1 : (dtz < 0 ? dtz - 1 : 0);
+        }
+
+        // A mating move has DTZ 1
+        if (dtz == 2 && pos.inCheck()) {
+            MoveList replies;
+            generateLegalMoves(pos, replies);
+            if (replies.empty()) dtz = 1;
+        }
+
+        pos.unmakeMove(moves[i], undo);
+        if (result == PROBE_FAIL) return false;
+
+        // Certain wins rank equally; losses rank equally unless the fifty-move rule may save them
+        ranks[i] = dtz > 0 ? (dtz + halfmove <= 99 && !repeated ? MAX_DTZ : MAX_DTZ - (dtz + halfmove))
+                 : dtz < 0 ? (-dtz * 2 + halfmove < 100 ? -MAX_DTZ : -MAX_DTZ + (-dtz + halfmove))
+                 : 0;
+    }
+
+    const int best = *std::max_element(ranks.begin(), ranks.end());
+    std::vector<Move> bestMoves;
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        if (ranks[i] == best) bestMoves.push_back(moves[i]);
+    }
+    moves = bestMoves;
+
+    // Cursed wins score 1..49 cp, growing as the real win gets closer
+    const int bound = config.rule50 ? MAX_DTZ - 100 : 1;
+    score = best >= bound ? VALUE_MATE_IN_MAX_PLY - 1
+          : best > 0 ? std::max(3, best - (MAX_DTZ - 200)) * PIECE_VALUES[static_cast<int>(PieceType::PAWN)] / 200
+          : best == 0 ? 0
+          : best > -bound ? std::min(-3, best + (MAX_DTZ - 200)) * PIECE_VALUES[static_cast<int>(PieceType::PAWN)] / 200
+          : -VALUE_MATE_IN_MAX_PLY + 1;
+    return true;
+}
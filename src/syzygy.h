@@ -0,0 +1,82 @@
+#ifndef SYZYGY_H
+#define SYZYGY_H
+
+#include <string>
+#include <vector>
+#include "position.h"
+#include "move.h"
+
+// Largest tablebases the prober understands
+constexpr int TB_MAX_PIECES = 7;
+
+// Game-theoretic value of a position for the side to move
+enum WDLScore {
+    WDL_LOSS         = -2,
+    WDL_BLESSED_LOSS = -1,  // Lost, but saved by the fifty-move rule
+    WDL_DRAW         = 0,
+    WDL_CURSED_WIN   = 1,   // Won, but spoiled by the fifty-move rule
+    WDL_WIN          = 2
+};
+
+// Outcome of a probe
+enum ProbeState {
+    PROBE_FAIL = 0,             // No table for this material (or a bad file)
+    PROBE_OK = 1,
+    PROBE_CHANGE_STM = -1,      // The DTZ table only stores the other side to move
+    PROBE_ZEROING_BEST_MOVE = 2 // The best move is a capture or pawn move
+};
+
+// How the search uses the tablebases; safe to change between searches
+struct TablebaseConfig {
+    int probeDepth = 1;         // Shallowest remaining depth probed at the largest piece count
+    int probeLimit = TB_MAX_PIECES;
+    bool rule50 = true;         // Score cursed wins and blessed losses as draws
+};
+
+void setTablebaseConfig(const TablebaseConfig& config);
+TablebaseConfig getTablebaseConfig();
+
+/**
+ * @brief Registers the Syzygy tables found in the given directories
+ *
+ * Directories are separated by ';' on Windows and ':' elsewhere; an empty
+ * path (or "<empty>") disables the tablebases. Only the existence of the
+ * .rtbw files is checked here: a table is memory-mapped on the first probe
+ * that needs it. Must not run during a search.
+ * @return Number of tables found
+ */
+int initTablebases(const std::string& paths);
+
+// Most pieces (kings included) of any table found, 0 when there are none
+int tablebaseMaxPieces();
+
+/**
+ * @brief Probes the win/draw/loss tables
+ *
+ * Thread-safe. The position must have no castling rights; it is changed
+ * while probing (captures are played and taken back) but restored.
+ */
+WDLScore probeWDL(Position& pos, ProbeState& result);
+
+/**
+ * @brief Probes the distance-to-zero tables
+ *
+ * Returns plies to the next capture or pawn move in the optimal line, with
+ * the sign of the WDL result (0 for a draw); values beyond +-100 are cursed
+ * wins and blessed losses. May be off by one ply.
+ */
+int probeDTZ(Position& pos, ProbeState& result);
+
+/**
+ * @brief Ranks the root moves by DTZ and keeps the best ones
+ *
+ * Wins that are safe under the fifty-move rule rank above slower wins,
+ * draws above losses, and slow losses above fast ones.
+ * @param moves In: candidate root moves; out: the moves that share the best rank
+ * @param history Keys of the game before the root, to score repetitions as draws
+ * @param score Set to a search score matching the best rank
+ * @return False if a probe failed (moves are left unchanged)
+ */
+bool probeRoot(Position& pos, const std::vector<Key>& history, std::vector<Move>& moves, int& score);
+
+#endif // SYZYGY_H
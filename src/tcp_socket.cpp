@@ -0,0 +1,214 @@
+#include <chrono>
+#include <mutex>
+#include "tcp_socket.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <csignal>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// Pending connections the listener queues before accept() takes them
+constexpr int LISTEN_BACKLOG = 64;
+
+#ifdef _WIN32
+
+SocketHandle TcpConnection::invalidHandle() { return static_cast<SocketHandle>(INVALID_SOCKET); }
+
+static void closeHandle(SocketHandle handle) { closesocket(static_cast<SOCKET>(handle)); }
+
+// Winsock has to be started once per process before any other call
+static bool startNetworking() {
+    static std::once_flag once;
+    static bool started = false;
+    std::call_once(once, [] {
+        WSADATA data;
+        started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    });
+    return started;
+}
+
+// Waits until the socket is readable; select() is the wait both Winsock versions have
+static bool waitReadable(SocketHandle handle, int timeoutMs) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(static_cast<SOCKET>(handle), &readable);
+    timeval timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    return select(0, &readable, nullptr, nullptr, timeoutMs < 0 ? nullptr : &timeout) > 0;
+}
+
+#else
+
+SocketHandle TcpConnection::invalidHandle() { return -1; }
+
+static void closeHandle(SocketHandle handle) { ::close(handle); }
+
+static bool startNetworking() {
+    // A peer that vanishes mid-write must not take us down with SIGPIPE
+    static std::once_flag once;
+    std::call_once(once, [] { std::signal(SIGPIPE, SIG_IGN); });
+    return true;
+}
+
+static bool waitReadable(SocketHandle handle, int timeoutMs) {
+    pollfd waitFor{handle, POLLIN, 0};
+    return poll(&waitFor, 1, timeoutMs < 0 ? -1 : timeoutMs) > 0;
+}
+
+#endif
+
+static long long nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Printable "address:port" of a socket address
+static std::string addressName(const sockaddr* address) {
+    char host[NI_MAXHOST] = "?";
+    char service[NI_MAXSERV] = "?";
+    const socklen_t length = address->sa_family == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+    getnameinfo(address, length, host, sizeof(host), service, sizeof(service), NI_NUMERICHOST | NI_NUMERICSERV);
+    return std::string(host) + ":" + service;
+}
+
+// Requests and replies are single short lines; do not hold them back to fill packets
+static void disableNagle(SocketHandle handle) {
+    int on = 1;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+}
+
+bool TcpConnection::connect(const std::string& host, int port) {
+    close();
+    if (!startNetworking()) return false;
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) return false;
+
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        const SocketHandle candidate = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (candidate == invalidHandle()) continue;
+        if (::connect(candidate, address->ai_addr, static_cast<socklen_t>(address->ai_addrlen)) == 0) {
+            handle = candidate;
+            peer = addressName(address->ai_addr);
+            break;
+        }
+        closeHandle(candidate);
+    }
+    freeaddrinfo(addresses);
+
+    if (!isOpen()) return false;
+    disableNagle(handle);
+    return true;
+}
+
+bool TcpConnection::writeLine(const std::string& line) {
+    if (!isOpen()) return false;
+    const std::string data = line + "\n";
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const auto n = send(handle, data.data() + sent, static_cast<int>(data.size() - sent), 0);
+        if (n <= 0) return false;
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool TcpConnection::readMore(int timeoutMs) {
+    if (!isOpen() || !waitReadable(handle, timeoutMs)) return false;
+
+    char buffer[4096];
+    const auto got = recv(handle, buffer, static_cast<int>(sizeof(buffer)), 0);
+    if (got <= 0) return false;
+    pending.append(buffer, static_cast<std::size_t>(got));
+    return true;
+}
+
+bool TcpConnection::readLine(std::string& line, int timeoutMs) {
+    const long long deadline = nowMs() + timeoutMs;
+    for (;;) {
+        const std::size_t newline = pending.find('\n');
+        if (newline != std::string::npos) {
+            line.assign(pending, 0, newline);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            pending.erase(0, newline + 1);
+            return true;
+        }
+        int wait = -1;
+        if (timeoutMs >= 0) {
+            const long long remaining = deadline - nowMs();
+            if (remaining <= 0) return false;
+            wait = static_cast<int>(remaining);
+        }
+        if (!readMore(wait)) return false;
+    }
+}
+
+bool TcpConnection::isOpen() const {
+    return handle != invalidHandle();
+}
+
+void TcpConnection::close() {
+    if (isOpen()) closeHandle(handle);
+    handle = invalidHandle();
+    pending.clear();
+    peer.clear();
+}
+
+bool TcpListener::listen(int port) {
+    close();
+    if (!startNetworking()) return false;
+
+    handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == TcpConnection::invalidHandle()) return false;
+
+#ifndef _WIN32
+    // A restarted coordinator must be able to take the port straight back (Windows allows it anyway)
+    int on = 1;
+    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+#endif
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<unsigned short>(port));
+    if (bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(handle, LISTEN_BACKLOG) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool TcpListener::accept(TcpConnection& connection, int timeoutMs) {
+    if (handle == TcpConnection::invalidHandle() || !waitReadable(handle, timeoutMs)) return false;
+
+    sockaddr_storage address{};
+    socklen_t length = sizeof(address);
+    const SocketHandle client = ::accept(handle, reinterpret_cast<sockaddr*>(&address), &length);
+    if (client == TcpConnection::invalidHandle()) return false;
+
+    connection.close();
+    connection.handle = client;
+    connection.peer = addressName(reinterpret_cast<const sockaddr*>(&address));
+    disableNagle(client);
+    return true;
+}
+
+void TcpListener::close() {
+    if (handle != TcpConnection::invalidHandle()) closeHandle(handle);
+    handle = TcpConnection::invalidHandle();
+}
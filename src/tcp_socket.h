@@ -0,0 +1,81 @@
+#ifndef TCP_SOCKET_H
+#define TCP_SOCKET_H
+
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+using SocketHandle = std::uintptr_t;
+#else
+using SocketHandle = int;
+#endif
+
+/**
+ * @brief A TCP connection talked to line by line
+ *
+ * Lines are plain text ending in a newline, the same framing as the pipes
+ * of ChildProcess. Uses BSD sockets on POSIX systems and Winsock on
+ * Windows, which needs -lws2_32 at link time.
+ */
+class TcpConnection {
+public:
+    TcpConnection() = default;
+    ~TcpConnection() { close(); }
+    TcpConnection(const TcpConnection&) = delete;
+    TcpConnection& operator=(const TcpConnection&) = delete;
+
+    // False if the host cannot be resolved or refuses the connection
+    bool connect(const std::string& host, int port);
+
+    // Sends one line (the newline is added); false once the connection is gone
+    bool writeLine(const std::string& line);
+
+    /**
+     * @brief Waits up to timeoutMs (forever if negative) for the next line
+     * @return False on timeout or when the other side closed the connection
+     */
+    bool readLine(std::string& line, int timeoutMs);
+
+    bool isOpen() const;
+    void close();
+
+    // Address of the other side, for messages
+    const std::string& peerName() const { return peer; }
+
+private:
+    friend class TcpListener;
+
+    SocketHandle handle = invalidHandle();
+    std::string pending;            // Received but not yet returned as a line
+    std::string peer;
+
+    static SocketHandle invalidHandle();
+
+    // Reads what is available, waiting up to timeoutMs; false on timeout or end of stream
+    bool readMore(int timeoutMs);
+};
+
+// A listening socket that hands out incoming connections
+class TcpListener {
+public:
+    TcpListener() = default;
+    ~TcpListener() { close(); }
+    TcpListener(const TcpListener&) = delete;
+    TcpListener& operator=(const TcpListener&) = delete;
+
+    // Listens on every interface; false if the port is taken
+    bool listen(int port);
+
+    /**
+     * @brief Waits up to timeoutMs for a client
+     * @return False on timeout or error; connection is untouched then
+     */
+    bool accept(TcpConnection& connection, int timeoutMs);
+
+    void close();
+
+private:
+    SocketHandle handle = TcpConnection::invalidHandle();
+};
+
+#endif // TCP_SOCKET_H
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <atomic>
+#include "timeman.h"
+#include "search.h"
+
+// Moves assumed left in the game when the GUI does not send movestogo
+constexpr int DEFAULT_MOVES_TO_GO = 30;
+
+static std::atomic<int> moveOverheadMs(DEFAULT_MOVE_OVERHEAD_MS);
+
+void setMoveOverhead(int ms) {
+    moveOverheadMs.store(ms < 0 ? 0 : (ms > 5000 ? 5000 : ms));
+}
+
+int getMoveOverhead() {
+    return moveOverheadMs.load();
+}
+
+void TimeManager::init(const SearchLimits& limits, PieceColor side) {
+    softLimit = 0;
+    hardLimit = 0;
+    fixedTime = false;
+    lastBestMove = NO_MOVE;
+    lastScore = 0;
+    stableIterations = 0;
+
+    const long long overhead = moveOverheadMs.load();
+
+    if (limits.moveTime > 0) {
+        hardLimit = std::max(1LL, limits.moveTime - overhead);
+        softLimit = hardLimit;
+        fixedTime = true;
+        return;
+    }
+
+    const long long time = limits.time[static_cast<int>(side)];
+    if (time <= 0) return;
+    const long long increment = limits.increment[static_cast<int>(side)];
+    const long long movesLeft = limits.movesToGo > 0 ? std::min(limits.movesToGo, 50) : DEFAULT_MOVES_TO_GO;
+    const long long available = std::max(1LL, time - overhead);
+
+    // The average share of the remaining time plus most of the increment
+    const long long optimum = available / movesLeft + increment * 3 / 4;
+
+    // An iteration takes about as long as all the ones before it, so stop
+    // starting new ones halfway to the optimum. Never plan to use more than
+    // three quarters of the clock on one move.
+    hardLimit = std::max(1LL, std::min(optimum * 3, available * 3 / 4));
+    softLimit = std::max(1LL, std::min(optimum / 2, hardLimit));
+}
+
+bool TimeManager::iterationDone(int depth, Move bestMove, int score, long long elapsedMs) {
+    if (!enabled()) return false;
+
+    stableIterations = (bestMove == lastBestMove) ? stableIterations + 1 : 0;
+
+    // 1.25x right after the best move changed, down to 0.75x once it has held for five iterations
+    double scale = 1.25 - 0.1 * std::min(stableIterations, 5);
+
+    // Up to 1.5x more when the score fell since the last iteration
+    if (depth > 1 && score < lastScore) {
+        scale *= 1.0 + 0.5 * std::min(lastScore - score, 100) / 100.0;
+    }
+
+    lastBestMove = bestMove;
+    lastScore = score;
+
+    if (fixedTime) return elapsedMs >= hardLimit;
+    return elapsedMs >= std::min(static_cast<long long>(softLimit * scale), hardLimit);
+}
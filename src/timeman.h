@@ -0,0 +1,55 @@
+#ifndef TIMEMAN_H
+#define TIMEMAN_H
+
+#include "chess_types.h"
+#include "move.h"
+
+struct SearchLimits;
+
+// The main search thread reads the clock once per this many nodes
+constexpr int TIME_CHECK_INTERVAL = 1024;
+
+// Default time kept back per move for GUI and network latency, in ms
+constexpr int DEFAULT_MOVE_OVERHEAD_MS = 30;
+
+// Time kept back per move (clamped to 0..5000 ms); safe to change between searches
+void setMoveOverhead(int ms);
+int getMoveOverhead();
+
+/**
+ * @brief Decides how long the main search thread may think about one move
+ *
+ * From the clock, increment and moves to go it derives two deadlines. The
+ * soft limit is checked between iterations: no new iteration starts once it
+ * has passed. The hard limit aborts the search in the middle of an
+ * iteration. The soft limit is scaled after every iteration: it shrinks
+ * while the best move stays the same and grows when the best move changes or
+ * the score drops. All times are ms since the clock started for this move.
+ */
+class TimeManager {
+public:
+    void init(const SearchLimits& limits, PieceColor side);
+
+    // False when the search has no time limit (depth, nodes or infinite)
+    bool enabled() const { return hardLimit > 0; }
+    long long softLimitMs() const { return softLimit; }
+    long long hardLimitMs() const { return hardLimit; }
+
+    bool hardLimitReached(long long elapsedMs) const { return enabled() && elapsedMs >= hardLimit; }
+
+    /**
+     * @brief Reports a completed iteration
+     * @return True if the next iteration should not be started
+     */
+    bool iterationDone(int depth, Move bestMove, int score, long long elapsedMs);
+
+private:
+    long long softLimit = 0;
+    long long hardLimit = 0;
+    bool fixedTime = false;     // "go movetime": use exactly the time given
+    Move lastBestMove = NO_MOVE;
+    int lastScore = 0;
+    int stableIterations = 0;   // Iterations in a row with the same best move
+};
+
+#endif // TIMEMAN_H
@@ -0,0 +1,81 @@
+#include <iomanip>
+#include <sstream>
+#include "trace.h"
+#include "search.h"
+
+thread_local TraceCounters* activeTrace = nullptr;
+
+void TraceCounters::add(const TraceCounters& other) {
+    qnodes += other.qnodes;
+    ttProbes += other.ttProbes;
+    ttHits += other.ttHits;
+    ttCutoffs += other.ttCutoffs;
+    betaCutoffs += other.betaCutoffs;
+    for (int i = 0; i < CUTOFF_INDEX_BUCKETS; ++i) {
+        cutoffsByIndex[i] += other.cutoffsByIndex[i];
+    }
+    movegenCalls += other.movegenCalls;
+    movegenNs += other.movegenNs;
+    evalCalls += other.evalCalls;
+    evalNs += other.evalNs;
+}
+
+static double percent(long long part, long long whole) {
+    return whole > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+static long long average(long long total, long long count) {
+    return count > 0 ? total / count : 0;
+}
+
+// Share of the reduced searches that stayed below alpha and needed no re-search
+static double lmrSuccess(const SearchStats& stats) {
+    return percent(stats.lmrReductions - stats.lmrResearches, stats.lmrReductions);
+}
+
+std::string traceSummary(const TraceCounters& trace, const SearchStats& stats, long long nodes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1)
+        << "nodes " << nodes
+        << " qnodes " << trace.qnodes
+        << " tthit " << percent(trace.ttHits, trace.ttProbes) << '%'
+        << " ttcut " << percent(trace.ttCutoffs, trace.ttProbes) << '%'
+        << " cutfirst " << percent(trace.cutoffsByIndex[0], trace.betaCutoffs) << '%'
+        << " cutidx";
+    for (int i = 0; i < CUTOFF_INDEX_BUCKETS; ++i) {
+        out << (i ? '/' : ' ') << trace.cutoffsByIndex[i];
+    }
+    out << " nmp " << percent(stats.nullMoveCutoffs, stats.nullMoveTries) << '%'
+        << " lmr " << lmrSuccess(stats) << '%'
+        << " movegen " << average(trace.movegenNs, trace.movegenCalls) << "ns"
+        << " eval " << average(trace.evalNs, trace.evalCalls) << "ns";
+    return out.str();
+}
+
+std::string traceJSON(const TraceCounters& trace, const SearchStats& stats, long long nodes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2)
+        << "{\"nodes\":" << nodes
+        << ",\"qnodes\":" << trace.qnodes
+        << ",\"tt_probes\":" << trace.ttProbes
+        << ",\"tt_hits\":" << trace.ttHits
+        << ",\"tt_cutoffs\":" << trace.ttCutoffs
+        << ",\"tt_hit_rate\":" << percent(trace.ttHits, trace.ttProbes)
+        << ",\"beta_cutoffs\":" << trace.betaCutoffs
+        << ",\"cutoffs_by_index\":[";
+    for (int i = 0; i < CUTOFF_INDEX_BUCKETS; ++i) {
+        out << (i ? "," : "") << trace.cutoffsByIndex[i];
+    }
+    out << "],\"first_move_cutoff_rate\":" << percent(trace.cutoffsByIndex[0], trace.betaCutoffs)
+        << ",\"null_move_tries\":" << stats.nullMoveTries
+        << ",\"null_move_cutoffs\":" << stats.nullMoveCutoffs
+        << ",\"null_move_success_rate\":" << percent(stats.nullMoveCutoffs, stats.nullMoveTries)
+        << ",\"lmr_reductions\":" << stats.lmrReductions
+        << ",\"lmr_researches\":" << stats.lmrResearches
+        << ",\"lmr_success_rate\":" << lmrSuccess(stats)
+        << ",\"movegen_calls\":" << trace.movegenCalls
+        << ",\"movegen_ns\":" << trace.movegenNs
+        << ",\"eval_calls\":" << trace.evalCalls
+        << ",\"eval_ns\":" << trace.evalNs << "}";
+    return out.str();
+}
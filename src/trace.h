@@ -0,0 +1,79 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <string>
+
+struct SearchStats;
+
+// Search instrumentation is compiled in only with -DUSE_TRACE ("make trace");
+// in other builds TRACE() statements vanish and the counters stay zero
+#ifdef USE_TRACE
+constexpr bool TRACE_ENABLED = true;
+#define TRACE(statement) statement
+#else
+constexpr bool TRACE_ENABLED = false;
+#define TRACE(statement)
+#endif
+
+// Beta cutoffs are counted by the number of the move that caused them: 1st, 2nd, ..., or later
+constexpr int CUTOFF_INDEX_BUCKETS = 8;
+
+/**
+ * @brief What one search thread did, for tuning move ordering and pruning
+ *
+ * Every search thread counts into its own instance, padded to a cache line
+ * so that threads never write to a shared line, and the instances are only
+ * summed when the search reports. Times are in nanoseconds and include the
+ * cost of reading the clock.
+ */
+struct alignas(64) TraceCounters {
+    long long qnodes = 0;                   // Nodes searched by quiescence search
+    long long ttProbes = 0;
+    long long ttHits = 0;
+    long long ttCutoffs = 0;                // Nodes answered from the table without a search
+    long long betaCutoffs = 0;
+    long long cutoffsByIndex[CUTOFF_INDEX_BUCKETS] = {};
+    long long movegenCalls = 0;             // Move generation stages run by the move picker
+    long long movegenNs = 0;
+    long long evalCalls = 0;
+    long long evalNs = 0;
+
+    void add(const TraceCounters& other);
+};
+
+// Counters of the search running on this thread, for code below the search such as the move picker
+extern thread_local TraceCounters* activeTrace;
+
+// Adds the lifetime of the timer to a nanosecond counter; a null counter is ignored
+class TraceTimer {
+public:
+    explicit TraceTimer(long long* total)
+        : total(total), start(std::chrono::steady_clock::now()) {}
+    ~TraceTimer() {
+        if (total) {
+            *total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    TraceTimer(const TraceTimer&) = delete;
+    TraceTimer& operator=(const TraceTimer&) = delete;
+
+private:
+    long long* total;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief The counters as space-separated "name value" pairs for a UCI info string
+ *
+ * Rates are derived on the way: TT hit and cutoff rates, the share of beta
+ * cutoffs caused by the first move, null-move and LMR success rates (from
+ * stats) and the average time per move generation and evaluation.
+ */
+std::string traceSummary(const TraceCounters& trace, const SearchStats& stats, long long nodes);
+
+// The same figures as one JSON object
+std::string traceJSON(const TraceCounters& trace, const SearchStats& stats, long long nodes);
+
+#endif // TRACE_H
@@ -0,0 +1,113 @@
+#include "tt.h"
+#include <iostream>
+#include <new>
+
+TranspositionTable TT;
+
+// Packed data layout (64 bits):
+//   bits  0-15 move, 16-31 score, 32-47 static eval,
+//   bits 48-55 depth, 56-57 bound, 58-63 generation
+static std::uint64_t packData(Move move, int score, int eval, int depth, Bound bound, std::uint8_t generation) {
+    return static_cast<std::uint64_t>(move) |
+           (static_cast<std::uint64_t>(static_cast<std::uint16_t>(score)) << 16) |
+           (static_cast<std::uint64_t>(static_cast<std::uint16_t>(eval)) << 32) |
+           (static_cast<std::uint64_t>(static_cast<std::uint8_t>(depth)) << 48) |
+           (static_cast<std::uint64_t>(bound) << 56) |
+           (static_cast<std::uint64_t>(generation) << 58);
+}
+
+static TTData unpackData(std::uint64_t data) {
+    TTData out;
+    out.move = static_cast<Move>(data & 0xFFFF);
+    out.score = static_cast<std::int16_t>((data >> 16) & 0xFFFF);
+    out.eval = static_cast<std::int16_t>((data >> 32) & 0xFFFF);
+    out.depth = static_cast<std::int8_t>((data >> 48) & 0xFF);
+    out.bound = static_cast<Bound>((data >> 56) & 0x3);
+    return out;
+}
+
+static std::uint8_t generationOf(std::uint64_t data) {
+    return static_cast<std::uint8_t>(data >> 58);
+}
+
+void TranspositionTable::resize(std::size_t mb) {
+    if (mb == 0) mb = 1;
+
+    const std::size_t count = mb * 1024 * 1024 / sizeof(Bucket);
+    buckets.reset(new (std::nothrow) Bucket[count]);
+    if (!buckets) {
+        std::cerr << "Warning: Could not allocate a " << mb << " MB hash table, using 1 MB" << std::endl;
+        mb = 1;
+        buckets.reset(new Bucket[mb * 1024 * 1024 / sizeof(Bucket)]);
+    }
+
+    bucketCount = mb * 1024 * 1024 / sizeof(Bucket);
+    megabytes = mb;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < bucketCount; ++i) {
+        for (Entry& entry : buckets[i].entries) {
+            entry.keyXorData.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation.store(0, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(Key key, TTData& out) const {
+    for (const Entry& entry : bucketFor(key).entries) {
+        const std::uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.keyXorData.load(std::memory_order_relaxed) ^ data) == key &&
+            static_cast<Bound>((data >> 56) & 0x3) != BOUND_NONE) {
+            out = unpackData(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(Key key, Move move, int score, int eval, int depth, Bound bound) {
+    Bucket& bucket = bucketFor(key);
+    Entry* replace = &bucket.entries[0];
+    int worstValue = 1 << 30;
+
+    for (Entry& entry : bucket.entries) {
+        const std::uint64_t data = entry.data.load(std::memory_order_relaxed);
+
+        // Same position: overwrite, but keep the old best move if we have none
+        if ((entry.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {
+            if (move == NO_MOVE) move = unpackData(data).move;
+            replace = &entry;
+            break;
+        }
+
+        // Otherwise evict the shallowest entry, counting stale ones as shallower
+        const int age = (generation.load(std::memory_order_relaxed) - generationOf(data)) & GENERATION_MASK;
+        const int value = static_cast<std::int8_t>((data >> 48) & 0xFF) - 8 * age;
+        if (value < worstValue) {
+            worstValue = value;
+            replace = &entry;
+        }
+    }
+
+    const std::uint64_t data = packData(move, score, eval, depth, bound, generation.load(std::memory_order_relaxed));
+    replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    const std::size_t samples = bucketCount < 250 ? bucketCount : 250;
+    int used = 0;
+    for (std::size_t i = 0; i < samples; ++i) {
+        for (const Entry& entry : buckets[i].entries) {
+            const std::uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (static_cast<Bound>((data >> 56) & 0x3) != BOUND_NONE &&
+                generationOf(data) == generation.load(std::memory_order_relaxed)) {
+                used++;
+            }
+        }
+    }
+    return samples ? static_cast<int>(used * 1000 / (samples * ENTRIES_PER_BUCKET)) : 0;
+}
@@ -0,0 +1,93 @@
+#ifndef TT_H
+#define TT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "move.h"
+#include "zobrist.h"
+
+// Default transposition table size
+constexpr std::size_t DEFAULT_HASH_MB = 16;
+
+// Which side of the true score a stored score lies on
+enum Bound : std::uint8_t {
+    BOUND_NONE  = 0,
+    BOUND_UPPER = 1,    // Failed low: true score <= stored score
+    BOUND_LOWER = 2,    // Failed high: true score >= stored score
+    BOUND_EXACT = 3
+};
+
+// Unpacked copy of a transposition table entry
+struct TTData {
+    Move move;
+    int score;
+    int eval;
+    int depth;
+    Bound bound;
+};
+
+/**
+ * @brief Fixed-size hash table of search results shared by all search threads
+ *
+ * Each entry is two 64-bit words: the packed data and the key XORed with that
+ * data. A reader recomputes the XOR and rejects the entry if the words came
+ * from two different writes, so threads can share the table with relaxed
+ * atomic loads and stores and no lock. Four entries share one 64-byte bucket;
+ * replacement prefers shallow entries left over from earlier searches.
+ */
+class TranspositionTable {
+public:
+    TranspositionTable() { resize(DEFAULT_HASH_MB); }
+
+    // Reallocates the table (clears it) - must not run during a search
+    void resize(std::size_t megabytes);
+    void clear();
+
+    // Ages the table at the start of every search
+    void newSearch() {
+        generation.store((generation.load(std::memory_order_relaxed) + 1) & GENERATION_MASK,
+                         std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Looks up a position
+     * @return True and fills data if the key was found
+     */
+    bool probe(Key key, TTData& data) const;
+    void store(Key key, Move move, int score, int eval, int depth, Bound bound);
+
+    // Approximate fill level in permille, sampled from the first buckets
+    int hashfull() const;
+
+    std::size_t sizeMB() const { return megabytes; }
+
+private:
+    static constexpr int ENTRIES_PER_BUCKET = 4;
+    static constexpr std::uint8_t GENERATION_MASK = 0x3F;
+
+    struct Entry {
+        std::atomic<std::uint64_t> keyXorData;
+        std::atomic<std::uint64_t> data;
+    };
+
+    struct alignas(64) Bucket {
+        Entry entries[ENTRIES_PER_BUCKET];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    std::size_t bucketCount = 0;
+    std::size_t megabytes = 0;
+    std::atomic<std::uint8_t> generation{0};  // Bumped by searches that may run side by side
+
+    Bucket& bucketFor(Key key) const {
+        // Map the key onto [0, bucketCount) without a division
+        return buckets[static_cast<std::size_t>((static_cast<__uint128_t>(key) * bucketCount) >> 64)];
+    }
+};
+
+// The table shared by every search
+extern TranspositionTable TT;
+
+#endif // TT_H
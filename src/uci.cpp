@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include "uci.h"
+#include "movegen.h"
+#include "search.h"
+#include "tt.h"
+#include "bench.h"
+#include "nnue.h"
+#include "timeman.h"
+#include "book.h"
+#include "syzygy.h"
+
+// Engine identification
+static const char* ENGINE_NAME = "Phosphor";
+static const char* ENGINE_AUTHOR = "Genius740Code";
+
+// stdout is shared by the input loop and the search thread
+static std::mutex outputMutex;
+
+static void send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
+}
+
+Move parseUCIMove(const Position& pos, const std::string& text) {
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    for (Move move : moves) {
+        if (moveToUCI(move) == text) return move;
+    }
+    return NO_MOVE;
+}
+
+static void sendInfo(const SearchResult& result) {
+    std::ostringstream info;
+    info << "info depth " << result.depth
+         << " score " << scoreToUCI(result.score)
+         << " nodes " << result.nodes
+         << " nps " << (result.timeMs > 0 ? result.nodes * 1000 / result.timeMs : result.nodes)
+         << " time " << result.timeMs
+         << " hashfull " << TT.hashfull()
+         << " tbhits " << result.stats.tbHits
+         << " pv";
+    for (Move move : result.pv) {
+        info << ' ' << moveToUCI(move);
+    }
+    send(info.str());
+}
+
+// Search statistics, sent once per search just before bestmove
+static void sendStats(const SearchStats& stats) {
+    std::ostringstream info;
+    info << "info string stats"
+         << " nmp " << stats.nullMoveTries << '/' << stats.nullMoveCutoffs << '/' << stats.nullMoveVerifications
+         << " lmr " << stats.lmrReductions << '/' << stats.lmrResearches
+         << " fut " << stats.futilityPrunes
+         << " rfp " << stats.reverseFutilityPrunes
+         << " razor " << stats.razorPrunes
+         << " checkext " << stats.checkExtensions;
+    send(info.str());
+}
+
+// Check options switching individual search techniques on and off
+struct FeatureOption {
+    const char* name;
+    bool SearchFeatures::*flag;
+};
+
+static const FeatureOption FEATURE_OPTIONS[] = {
+    {"Null Move Pruning", &SearchFeatures::nullMove},
+    {"Late Move Reductions", &SearchFeatures::lateMoveReductions},
+    {"Futility Pruning", &SearchFeatures::futility},
+    {"Reverse Futility Pruning", &SearchFeatures::reverseFutility},
+    {"Razoring", &SearchFeatures::razoring},
+    {"Check Extensions", &SearchFeatures::checkExtensions},
+};
+
+// "OwnBook": answer from the opening book while the position is in it
+static bool useOwnBook = false;
+
+static const FeatureOption* findFeatureOption(const std::string& name) {
+    for (const FeatureOption& option : FEATURE_OPTIONS) {
+        if (name == option.name) return &option;
+    }
+    return nullptr;
+}
+
+// Engine state between commands
+class UCIEngine {
+public:
+    UCIEngine() { position.setFromFEN(START_FEN); }
+    ~UCIEngine() { stopSearch(); }
+
+    // Handles one command; returns false on "quit"
+    bool handle(const std::string& line);
+
+private:
+    Position position;
+    std::vector<Key> history;       // Keys of the positions before the current one
+    std::thread searchThread;
+
+    void stopSearch();
+    void setPosition(std::istringstream& args);
+    void go(std::istringstream& args);
+    void setOption(std::istringstream& args);
+};
+
+void UCIEngine::stopSearch() {
+    if (searchThread.joinable()) {
+        requestStop();
+        searchThread.join();
+    }
+}
+
+void UCIEngine::setPosition(std::istringstream& args) {
+    std::string token;
+    std::string fen;
+    args >> token;
+
+    if (token == "startpos") {
+        fen = START_FEN;
+        args >> token; // "moves", if present
+    } else if (token == "fen") {
+        while (args >> token && token != "moves") {
+            fen += token + ' ';
+        }
+    } else {
+        return;
+    }
+
+    Position next;
+    if (!next.setFromFEN(fen)) {
+        std::cerr << "Warning: Invalid FEN string '" << fen << "', position unchanged" << std::endl;
+        return;
+    }
+    position = next;
+    history.clear();
+
+    while (args >> token) {
+        const Move move = parseUCIMove(position, token);
+        if (move == NO_MOVE) {
+            std::cerr << "Warning: Illegal move '" << token << "' ignored" << std::endl;
+            break;
+        }
+        history.push_back(position.hashKey());
+        position.doMove(move);
+    }
+}
+
+void UCIEngine::go(std::istringstream& args) {
+    stopSearch();
+
+    SearchLimits limits;
+    bool ponder = false;
+    std::string token;
+    bool readingMoves = false;      // Inside "searchmoves", which runs until the next keyword
+    while (args >> token) {
+        if (readingMoves) {
+            const Move move = parseUCIMove(position, token);
+            if (move != NO_MOVE) {
+                limits.searchMoves.push_back(move);
+                continue;
+            }
+            readingMoves = false;
+        }
+
+        if (token == "wtime") args >> limits.time[static_cast<int>(PieceColor::WHITE)];
+        else if (token == "btime") args >> limits.time[static_cast<int>(PieceColor::BLACK)];
+        else if (token == "winc") args >> limits.increment[static_cast<int>(PieceColor::WHITE)];
+        else if (token == "binc") args >> limits.increment[static_cast<int>(PieceColor::BLACK)];
+        else if (token == "movestogo") args >> limits.movesToGo;
+        else if (token == "movetime") args >> limits.moveTime;
+        else if (token == "depth") args >> limits.depth;
+        else if (token == "nodes") args >> limits.nodes;
+        else if (token == "infinite") limits.infinite = true;
+        else if (token == "ponder") ponder = true;
+        else if (token == "searchmoves") readingMoves = true;
+    }
+    if (limits.depth < 1) limits.depth = 1;
+
+    // A book move needs no search; when pondering or analysing, search anyway
+    if (useOwnBook && !ponder && !limits.infinite) {
+        const Move bookMove = BOOK.probe(position);
+        if (bookMove != NO_MOVE) {
+            send("info string Book move");
+            send("bestmove " + moveToUCI(bookMove));
+            return;
+        }
+    }
+
+    prepareSearch(ponder);
+    searchThread = std::thread([root = position, keys = history, limits] {
+        const SearchResult result = searchPosition(root, limits, keys, sendInfo);
+
+        // While pondering or in infinite mode the move may only be sent once the GUI asks for it
+        while ((limits.infinite || isPondering()) && !isStopRequested()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        sendStats(result.stats);
+        if (TRACE_ENABLED) send("info string trace " + traceSummary(result.trace, result.stats, result.nodes));
+        std::string line = "bestmove " + moveToUCI(result.bestMove);
+        if (result.pv.size() > 1) line += " ponder " + moveToUCI(result.pv[1]);
+        send(line);
+    });
+}
+
+void UCIEngine::setOption(std::istringstream& args) {
+    // setoption name <id> [value <x>]
+    std::string token, name, value;
+    args >> token; // "name"
+    while (args >> token && token != "value") {
+        name += (name.empty() ? "" : " ") + token;
+    }
+    while (args >> token) {
+        value += (value.empty() ? "" : " ") + token;
+    }
+
+    if (name == "Hash") {
+        stopSearch();
+        TT.resize(static_cast<std::size_t>(std::stoul(value)));
+    } else if (name == "Threads") {
+        stopSearch();
+        setSearchThreads(std::stoi(value));
+    } else if (name == "Move Overhead") {
+        setMoveOverhead(std::stoi(value));
+    } else if (name == "Clear Hash") {
+        stopSearch();
+        TT.clear();
+    } else if (name == "EvalFile") {
+        // An empty value (or "<empty>") switches back to the classical evaluation
+        stopSearch();
+        if (value.empty() || value == "<empty>") {
+            unloadNetwork();
+            send("info string Using classical evaluation");
+        } else if (loadNetwork(value)) {
+            send("info string Using network " + value + " (" + nnueKernelName() + ")");
+        } else {
+            send("info string Using classical evaluation");
+        }
+    } else if (name == "OwnBook") {
+        useOwnBook = (value == "true");
+    } else if (name == "BookFile") {
+        // An empty value (or "<empty>") closes the book
+        if (value.empty() || value == "<empty>") {
+            BOOK.close();
+        } else if (BOOK.open(value)) {
+            send("info string Using book " + value + " (" + std::to_string(BOOK.entryCount()) + " entries)");
+        }
+    } else if (name == "SyzygyPath") {
+        // An empty value (or "<empty>") switches the tablebases off
+        stopSearch();
+        const int found = initTablebases(value);
+        if (found > 0) {
+            send("info string Found " + std::to_string(found) + " tablebases (up to " +
+                 std::to_string(tablebaseMaxPieces()) + " pieces)");
+        }
+    } else if (name == "SyzygyProbeDepth" || name == "SyzygyProbeLimit" || name == "Syzygy50MoveRule") {
+        stopSearch();
+        TablebaseConfig config = getTablebaseConfig();
+        if (name == "SyzygyProbeDepth") config.probeDepth = std::max(1, std::min(std::stoi(value), 100));
+        else if (name == "SyzygyProbeLimit") config.probeLimit = std::max(0, std::min(std::stoi(value), TB_MAX_PIECES));
+        else config.rule50 = (value == "true");
+        setTablebaseConfig(config);
+    } else if (const FeatureOption* option = findFeatureOption(name)) {
+        stopSearch();
+        SearchFeatures features = getSearchFeatures();
+        features.*(option->flag) = (value == "true");
+        setSearchFeatures(features);
+    } else if (name != "Ponder") {
+        std::cerr << "Warning: Unknown option '" << name << "'" << std::endl;
+    }
+}
+
+bool UCIEngine::handle(const std::string& line) {
+    std::istringstream args(line);
+    std::string command;
+    args >> command;
+
+    if (command == "uci") {
+        send(std::string("id name ") + ENGINE_NAME);
+        send(std::string("id author ") + ENGINE_AUTHOR);
+        send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) + " min 1 max 65536");
+        send("option name Threads type spin default 1 min 1 max " + std::to_string(MAX_SEARCH_THREADS));
+        send("option name Ponder type check default false");
+        send("option name Move Overhead type spin default " + std::to_string(DEFAULT_MOVE_OVERHEAD_MS) +
+             " min 0 max 5000");
+        send("option name Clear Hash type button");
+        send(std::string("option name EvalFile type string default ") + DEFAULT_EVAL_FILE);
+        send("option name OwnBook type check default false");
+        send("option name BookFile type string default <empty>");
+        send("option name SyzygyPath type string default <empty>");
+        send("option name SyzygyProbeDepth type spin default 1 min 1 max 100");
+        send("option name SyzygyProbeLimit type spin default " + std::to_string(TB_MAX_PIECES) +
+             " min 0 max " + std::to_string(TB_MAX_PIECES));
+        send("option name Syzygy50MoveRule type check default true");
+        for (const FeatureOption& option : FEATURE_OPTIONS) {
+            send(std::string("option name ") + option.name + " type check default true");
+        }
+        send("uciok");
+    } else if (command == "isready") {
+        send("readyok");
+    } else if (command == "ucinewgame") {
+        stopSearch();
+        TT.clear();
+    } else if (command == "position") {
+        stopSearch();
+        setPosition(args);
+    } else if (command == "go") {
+        go(args);
+    } else if (command == "stop") {
+        stopSearch();
+    } else if (command == "ponderhit") {
+        ponderHit();
+    } else if (command == "setoption") {
+        try {
+            setOption(args);
+        } catch (const std::exception&) {
+            std::cerr << "Warning: Bad setoption value in '" << line << "'" << std::endl;
+        }
+    } else if (command == "bench") {
+        // Not part of UCI, but handy for checking a build from a GUI console
+        stopSearch();
+        int depth = DEFAULT_BENCH_DEPTH;
+        std::string format = "human";
+        args >> depth >> format;
+        std::lock_guard<std::mutex> lock(outputMutex);
+        runBench(depth, format);
+    } else if (command == "d") {
+        send(position.toFEN());
+    } else if (command == "quit") {
+        stopSearch();
+        return false;
+    }
+    return true;
+}
+
+void runUCI(bool answerUci) {
+    UCIEngine engine;
+    std::string line;
+
+    if (answerUci) engine.handle("uci");
+    while (std::getline(std::cin, line)) {
+        if (!engine.handle(line)) break;
+    }
+}
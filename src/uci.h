@@ -0,0 +1,20 @@
+#ifndef UCI_H
+#define UCI_H
+
+#include <string>
+#include "position.h"
+#include "move.h"
+
+/**
+ * @brief Runs the engine over the UCI protocol on stdin/stdout until "quit"
+ *
+ * Searches run on a background thread so that "stop" and "ponderhit" are
+ * handled while the engine is thinking.
+ * @param answerUci Reply to a "uci" command the caller has already read
+ */
+void runUCI(bool answerUci);
+
+// Finds the legal move written in UCI notation ("e2e4", "e7e8q"), or NO_MOVE
+Move parseUCIMove(const Position& pos, const std::string& text);
+
+#endif // UCI_H
@@ -0,0 +1,38 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include "chess_types.h"
+
+// 64-bit Zobrist hash of a position
+using Key = std::uint64_t;
+
+// Random keys XORed together to identify a position
+extern Key ZOBRIST_PIECE_KEYS[64][PIECE_TYPE_COUNT][COLOR_COUNT]; // [square][piece type][color]
+extern Key ZOBRIST_EP_FILE_KEYS[8];                              // [file of the en passant square]
+extern Key ZOBRIST_CASTLING_KEYS[16];                            // [castling rights bitmask]
+extern Key ZOBRIST_SIDE_TO_MOVE_KEY;                             // Black to move
+
+// Polyglot opening books use keys of their own: 768 piece-square keys
+// (index 64 * kind + square, kind = 2 * type + (white ? 1 : 0) with types
+// ordered pawn, knight, bishop, rook, queen, king), then 4 castling keys,
+// 8 en passant file keys and the White-to-move key
+constexpr int POLYGLOT_RANDOM_COUNT = 781;
+constexpr int POLYGLOT_CASTLING_OFFSET = 768;
+constexpr int POLYGLOT_EP_OFFSET = 772;
+constexpr int POLYGLOT_TURN_OFFSET = 780;
+extern const Key POLYGLOT_RANDOM[POLYGLOT_RANDOM_COUNT];
+
+/**
+ * @brief Fills the key tables from a fixed seed
+ *
+ * Must run once at program startup, before any position is set up, so that
+ * keys are identical from run to run.
+ */
+void initZobristKeys();
+
+inline Key pieceKey(int sq, PieceType type, PieceColor color) {
+    return ZOBRIST_PIECE_KEYS[sq][static_cast<int>(type)][static_cast<int>(color)];
+}
+
+#endif // ZOBRIST_H